@@ -0,0 +1,76 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "ocean.hpp"
+#include "algae.hpp"
+#include "herbivore.hpp"
+#include "predator.hpp"
+#include "utils/random.hpp"
+
+namespace Bench {
+
+struct Placement {
+    EntityType type;
+    int r;
+    int c;
+};
+
+// Same densities as OceanGame::OnUserCreate: 1/15 algae, 1/100 herbivores, 1/300 predators.
+inline std::vector<Placement> randomPlacements(int rows, int cols, int algae_div = 15, int herbivore_div = 100, int predator_div = 300) {
+    std::vector<Placement> placements;
+    const std::pair<EntityType, int> species[] = {
+        {EntityType::ALGAE, algae_div}, {EntityType::HERBIVORE, herbivore_div}, {EntityType::PREDATOR, predator_div}};
+    for (const auto& entry : species) {
+        for (int i = 0; i < rows * cols / entry.second; ++i) {
+            placements.push_back({entry.first, Random::getInt(0, rows - 1), Random::getInt(0, cols - 1)});
+        }
+    }
+    return placements;
+}
+
+inline void place(Ocean& ocean, const std::vector<Placement>& placements) {
+    for (const Placement& p : placements) {
+        switch (p.type) {
+            case EntityType::ALGAE:     ocean.addEntity(ocean.createEntity<Algae>(), p.r, p.c); break;
+            case EntityType::HERBIVORE: ocean.addEntity(ocean.createEntity<HerbivoreFish>(), p.r, p.c); break;
+            case EntityType::PREDATOR:  ocean.addEntity(ocean.createEntity<PredatorFish>(), p.r, p.c); break;
+            default: break;
+        }
+    }
+}
+
+inline void populate(Ocean& ocean, int algae_div = 15, int herbivore_div = 100, int predator_div = 300) {
+    place(ocean, randomPlacements(ocean.getRows(), ocean.getCols(), algae_div, herbivore_div, predator_div));
+}
+
+class Stopwatch {
+public:
+    Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+    double elapsedSeconds() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_;
+};
+
+inline double median(std::vector<double> samples) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+// Nearest-rank percentile, p in [0, 100].
+inline double percentile(std::vector<double> samples, double p) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    const size_t rank = static_cast<size_t>(p / 100.0 * static_cast<double>(samples.size()) + 0.999999);
+    return samples[std::min(samples.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+}
@@ -0,0 +1,404 @@
+#include "bench_common.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "neighbor_list.hpp"
+#include "utils/logger.hpp"
+
+// Seeded scenarios and grid sizes for whole ticks, plus the Ocean primitives
+// the species code leans on. Prints one machine-readable row per benchmark
+// (CSV by default, JSON with --format json) with the median, p99 and max of
+// the samples, the matching throughput and the worker thread count. p99 is
+// left empty (null in JSON) below P99_MIN_SAMPLES, where nearest-rank p99 is
+// just the max. Ticks with more than one thread are not reproducible in the
+// default in-place mode, so compare rows only at equal thread counts.
+namespace {
+
+struct Scenario {
+    const char* name;
+    int algae_div;
+    int herbivore_div;
+    int predator_div;
+};
+
+const Scenario SCENARIOS[] = {
+    {"default", 15, 100, 300},
+    {"sparse", 100, 1000, 3000},
+    {"dense-algae", 3, 100, 300},
+    {"predator-heavy", 15, 50, 50},
+};
+
+struct SuiteOptions {
+    std::vector<int> sizes = {256, 1024, 4096};
+    int ticks = 20;
+    int warmup = 2;
+    int threads = 1;
+    std::uint64_t seed = 42;
+    bool json = false;
+    std::string filter;
+};
+
+// Keeps the primitive loops from being optimized away.
+volatile std::uint64_t bench_sink = 0;
+
+// Primitive samples time BATCH calls each; the reported figure is per call.
+constexpr int BATCH = 4096;
+constexpr int PRIMITIVE_SAMPLES = 100;
+constexpr std::size_t P99_MIN_SAMPLES = 100;
+
+struct Result {
+    std::string benchmark;
+    std::string scenario;
+    int size;
+    const char* unit;       // of median/p99/max
+    const char* throughput; // unit of 1e9 / median
+    std::vector<double> samples;
+    int threads = 1;
+};
+
+class Reporter {
+public:
+    explicit Reporter(bool json) : json_(json) {
+        if (json_) {
+            std::cout << "[\n";
+        } else {
+            std::cout << "benchmark,scenario,size,threads,samples,unit,median,p99,max,throughput,throughput_unit\n";
+        }
+    }
+
+    ~Reporter() {
+        if (json_) {
+            std::cout << "\n]\n";
+        }
+    }
+
+    void report(const Result& result) {
+        const double median = Bench::median(result.samples);
+        const double max = result.samples.empty() ? 0.0 : *std::max_element(result.samples.begin(), result.samples.end());
+        const double throughput = median > 0.0 ? 1e9 / median : 0.0;
+        std::ostringstream p99;
+        if (result.samples.size() >= P99_MIN_SAMPLES) {
+            p99 << Bench::percentile(result.samples, 99.0);
+        } else if (json_) {
+            p99 << "null";
+        }
+        std::ostringstream row;
+        if (json_) {
+            row << (first_ ? "" : ",\n") << "  {\"benchmark\": \"" << result.benchmark << "\", \"scenario\": \""
+                << result.scenario << "\", \"size\": " << result.size << ", \"threads\": " << result.threads
+                << ", \"samples\": " << result.samples.size() << ", \"unit\": \"" << result.unit
+                << "\", \"median\": " << median << ", \"p99\": " << p99.str() << ", \"max\": " << max
+                << ", \"throughput\": " << throughput << ", \"throughput_unit\": \"" << result.throughput << "\"}";
+        } else {
+            row << result.benchmark << "," << result.scenario << "," << result.size << "," << result.threads << ","
+                << result.samples.size() << "," << result.unit << "," << median << "," << p99.str() << "," << max << ","
+                << throughput << "," << result.throughput << "\n";
+        }
+        std::cout << row.str() << std::flush;
+        first_ = false;
+    }
+
+private:
+    bool json_;
+    bool first_ = true;
+};
+
+std::vector<int> parseSizes(const std::string& list) {
+    std::vector<int> sizes;
+    std::istringstream in(list);
+    std::string item;
+    while (std::getline(in, item, ',')) {
+        sizes.push_back(std::stoi(item));
+    }
+    return sizes;
+}
+
+SuiteOptions parseOptions(int argc, char** argv) {
+    SuiteOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--sizes") {
+            options.sizes = parseSizes(value());
+        } else if (arg == "--ticks") {
+            options.ticks = std::stoi(value());
+        } else if (arg == "--warmup") {
+            options.warmup = std::stoi(value());
+        } else if (arg == "--threads") {
+            options.threads = std::stoi(value());
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(value());
+        } else if (arg == "--format") {
+            const std::string format = value();
+            if (format != "csv" && format != "json") {
+                throw std::invalid_argument("unknown format " + format);
+            }
+            options.json = format == "json";
+        } else if (arg == "--filter") {
+            options.filter = value();
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    return options;
+}
+
+bool selected(const SuiteOptions& options, const std::string& benchmark, const std::string& scenario, int size) {
+    if (options.filter.empty()) {
+        return true;
+    }
+    return (benchmark + "/" + scenario + "/" + std::to_string(size)).find(options.filter) != std::string::npos;
+}
+
+std::vector<std::pair<int, int>> randomCells(int size, int count) {
+    std::vector<std::pair<int, int>> cells;
+    cells.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        cells.push_back({Random::getInt(0, size - 1), Random::getInt(0, size - 1)});
+    }
+    return cells;
+}
+
+template<typename Fn>
+std::vector<double> sampleBatches(Fn&& batch) {
+    std::vector<double> samples;
+    for (int s = 0; s < PRIMITIVE_SAMPLES; ++s) {
+        Bench::Stopwatch watch;
+        batch();
+        samples.push_back(watch.elapsedSeconds() * 1e9 / BATCH);
+    }
+    return samples;
+}
+
+void runTicks(const SuiteOptions& options, const Scenario& scenario, int size, Reporter& reporter) {
+    Random::seed(options.seed);
+    Ocean ocean(size, size);
+    ocean.setIntentSeed(options.seed);
+    ocean.setThreadCount(options.threads);
+    Bench::place(ocean, Bench::randomPlacements(size, size, scenario.algae_div, scenario.herbivore_div, scenario.predator_div));
+    for (int t = 0; t < options.warmup; ++t) {
+        ocean.tick();
+    }
+
+    Result result{"tick", scenario.name, size, "ns/tick", "ticks/s", {}, options.threads};
+    for (int t = 0; t < options.ticks; ++t) {
+        Bench::Stopwatch watch;
+        ocean.tick();
+        result.samples.push_back(watch.elapsedSeconds() * 1e9);
+    }
+    reporter.report(result);
+}
+
+// Herbivores seeking food as a percentage of the cells, over the default
+// algae. The flow-field rows tick in UpdateMode::INTENT, where the outcome
+// does not depend on the flow field mode, so the three modes time the same
+// ticks; AUTO pays off where "always" drops below "off".
+const int FLOW_FIELD_SEEKER_PERCENTS[] = {1, 5, 10, 25, 50};
+
+void runFlowFields(const SuiteOptions& options, int size, Reporter& reporter) {
+    const std::pair<const char*, FlowFieldMode> modes[] = {
+        {"flow-field/off", FlowFieldMode::OFF}, {"flow-field/auto", FlowFieldMode::AUTO}, {"flow-field/always", FlowFieldMode::ALWAYS}};
+    for (int percent : FLOW_FIELD_SEEKER_PERCENTS) {
+        const std::string scenario = "seekers-" + std::to_string(percent) + "pct";
+        for (const auto& mode : modes) {
+            if (!selected(options, mode.first, scenario, size)) {
+                continue;
+            }
+            Random::seed(options.seed);
+            Ocean ocean(size, size);
+            ocean.setIntentSeed(options.seed);
+            ocean.setThreadCount(options.threads);
+            ocean.setUpdateMode(UpdateMode::INTENT);
+            ocean.setFlowFieldMode(mode.second);
+            for (int i = 0; i < size * size / 15; ++i) {
+                ocean.addEntity(ocean.createEntity<Algae>(), Random::getInt(0, size - 1), Random::getInt(0, size - 1));
+            }
+            const long long seekers = static_cast<long long>(size) * size * percent / 100;
+            for (long long i = 0; i < seekers; ++i) {
+                ocean.addEntity(ocean.createEntity<HerbivoreFish>(Config::HERBIVORE_CRITICAL_ENERGY_THRESHOLD),
+                                Random::getInt(0, size - 1), Random::getInt(0, size - 1));
+            }
+
+            Result result{mode.first, scenario, size, "ns/tick", "ticks/s", {}, options.threads};
+            for (int t = 0; t < options.ticks; ++t) {
+                Bench::Stopwatch watch;
+                ocean.tick();
+                result.samples.push_back(watch.elapsedSeconds() * 1e9);
+            }
+            reporter.report(result);
+        }
+    }
+}
+
+void runPrimitives(const SuiteOptions& options, int size, Reporter& reporter) {
+    const Scenario& scenario = SCENARIOS[0];
+    Random::seed(options.seed);
+    Ocean ocean(size, size);
+    Bench::place(ocean, Bench::randomPlacements(size, size, scenario.algae_div, scenario.herbivore_div, scenario.predator_div));
+    for (int t = 0; t < options.warmup; ++t) {
+        ocean.tick();
+    }
+    const std::vector<std::pair<int, int>> cells = randomCells(size, BATCH);
+    std::uint64_t sink = 0;
+
+    auto run = [&](const char* name, auto&& batch) {
+        if (selected(options, name, scenario.name, size)) {
+            reporter.report({name, scenario.name, size, "ns/op", "ops/s", sampleBatches(batch)});
+        }
+    };
+
+    run("getEmptyAdjacentCells", [&] {
+        NeighborList out;
+        for (const auto& cell : cells) {
+            ocean.getEmptyAdjacentCells(cell.first, cell.second, out);
+            sink += out.size();
+        }
+    });
+    run("getAdjacentCellsOfType", [&] {
+        NeighborList out;
+        for (const auto& cell : cells) {
+            ocean.getAdjacentCellsOfType(cell.first, cell.second, EntityType::ALGAE, out);
+            sink += out.size();
+        }
+    });
+    run("getDirectionToNearestTarget/algae", [&] {
+        for (const auto& cell : cells) {
+            sink += ocean.getDirectionToNearestTarget(cell.first, cell.second, EntityType::ALGAE, Config::HERBIVORE_SIGHT_RADIUS).first;
+        }
+    });
+    run("getDirectionToNearestTarget/herbivore", [&] {
+        for (const auto& cell : cells) {
+            sink += ocean.getDirectionToNearestTarget(cell.first, cell.second, EntityType::HERBIVORE, Config::PREDATOR_SIGHT_RADIUS).first;
+        }
+    });
+
+    // add and move time BATCH operations on distinct cells that were empty
+    // when the batch was prepared; the setup and cleanup are not timed.
+    std::vector<std::pair<int, int>> placed;
+    std::vector<char> claimed(static_cast<size_t>(size) * size, 0);
+    auto claim = [&](const std::pair<int, int>& cell) {
+        char& flag = claimed[static_cast<size_t>(cell.first) * size + cell.second];
+        if (flag || ocean.getEntity(cell.first, cell.second)) {
+            return false;
+        }
+        flag = 1;
+        return true;
+    };
+    auto prepareEmpty = [&] {
+        std::fill(claimed.begin(), claimed.end(), 0);
+        placed.clear();
+        for (const auto& cell : randomCells(size, BATCH * 2)) {
+            if (placed.size() < static_cast<size_t>(BATCH) && claim(cell)) {
+                placed.push_back(cell);
+            }
+        }
+    };
+    auto cleanup = [&] {
+        for (const auto& cell : placed) {
+            ocean.removeEntity(cell.first, cell.second);
+        }
+    };
+    if (selected(options, "addEntity", scenario.name, size)) {
+        std::vector<double> samples;
+        for (int s = 0; s < PRIMITIVE_SAMPLES; ++s) {
+            prepareEmpty();
+            Bench::Stopwatch watch;
+            for (const auto& cell : placed) {
+                sink += ocean.addEntity(ocean.createEntity<HerbivoreFish>(), cell.first, cell.second);
+            }
+            samples.push_back(watch.elapsedSeconds() * 1e9 / static_cast<double>(std::max<size_t>(placed.size(), 1)));
+            cleanup();
+        }
+        reporter.report({"addEntity", scenario.name, size, "ns/op", "ops/s", samples});
+    }
+    if (selected(options, "moveEntity", scenario.name, size)) {
+        std::vector<double> samples;
+        std::vector<std::pair<int, int>> targets;
+        for (int s = 0; s < PRIMITIVE_SAMPLES; ++s) {
+            prepareEmpty();
+            targets.clear();
+            for (const auto& cell : placed) {
+                ocean.addEntity(ocean.createEntity<HerbivoreFish>(), cell.first, cell.second);
+            }
+            for (const auto& cell : placed) {
+                NeighborList empty;
+                ocean.getEmptyAdjacentCells(cell.first, cell.second, empty);
+                std::pair<int, int> target = cell;
+                for (const auto& candidate : empty) {
+                    if (claim(candidate)) {
+                        target = candidate;
+                        break;
+                    }
+                }
+                targets.push_back(target);
+            }
+            Bench::Stopwatch watch;
+            for (size_t i = 0; i < placed.size(); ++i) {
+                if (targets[i] != placed[i] && ocean.moveEntity(placed[i].first, placed[i].second, targets[i].first, targets[i].second)) {
+                    placed[i] = targets[i];
+                    ++sink;
+                }
+            }
+            samples.push_back(watch.elapsedSeconds() * 1e9 / static_cast<double>(std::max<size_t>(placed.size(), 1)));
+            cleanup();
+        }
+        reporter.report({"moveEntity", scenario.name, size, "ns/op", "ops/s", samples});
+    }
+
+    // With the log file closed these are the calls the species code makes
+    // on every update; in NDEBUG builds the debug call compiles away.
+    run("Logger::debug/filtered", [&] {
+        for (const auto& cell : cells) {
+            Logger::debug("H @(", cell.first, ",", cell.second, ") moving randomly.");
+        }
+    });
+    run("Logger::info/filtered", [&] {
+        for (const auto& cell : cells) {
+            Logger::info("H at (", cell.first, ",", cell.second, ") ate Algae. E:", 42);
+        }
+    });
+
+    bench_sink = sink;
+}
+
+}
+
+// Usage: OceanBench [--sizes 256,1024,4096] [--ticks 20] [--warmup 2] [--threads 1]
+//                   [--seed 42] [--format csv|json] [--filter substring]
+// --filter matches against "benchmark/scenario/size", e.g. "tick/sparse" or "/1024".
+// The flow-field sweep is long and only runs when the filter names it, e.g.
+// --filter flow-field or --filter flow-field/always.
+int main(int argc, char** argv) {
+    SuiteOptions options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 2;
+    }
+
+    Reporter reporter(options.json);
+    for (int size : options.sizes) {
+        for (const Scenario& scenario : SCENARIOS) {
+            if (selected(options, "tick", scenario.name, size)) {
+                runTicks(options, scenario, size, reporter);
+            }
+        }
+        runPrimitives(options, size, reporter);
+        if (options.filter.find("flow-field") != std::string::npos) {
+            runFlowFields(options, size, reporter);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include "bench_common.hpp"
+
+#include <cstdlib>
+#include <string>
+
+// Compares DispatchMode::VIRTUAL with DispatchMode::BY_SPECIES.
+// Usage: OceanDispatchBench [size=256] [ticks=50] [repeats=5]
+int main(int argc, char** argv) {
+    const int size = argc > 1 ? std::atoi(argv[1]) : 256;
+    const int ticks = argc > 2 ? std::atoi(argv[2]) : 50;
+    const int repeats = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    std::printf("grid %dx%d, %d ticks, %d repeats\n", size, size, ticks, repeats);
+    std::printf("%-12s %14s %16s %12s\n", "mode", "ms/tick", "ns/entity-upd", "population");
+
+    const DispatchMode modes[] = {DispatchMode::VIRTUAL, DispatchMode::BY_SPECIES};
+    for (DispatchMode mode : modes) {
+        std::vector<double> ms_per_tick;
+        std::vector<double> ns_per_update;
+        PopulationStats final_pop;
+        for (int rep = 0; rep < repeats; ++rep) {
+            Ocean ocean(size, size);
+            Bench::populate(ocean);
+            ocean.setDispatchMode(mode);
+
+            double seconds = 0.0;
+            long long updates = 0;
+            for (int t = 0; t < ticks; ++t) {
+                updates += ocean.getPopulationStats().total();
+                Bench::Stopwatch watch;
+                ocean.tick();
+                seconds += watch.elapsedSeconds();
+            }
+            ms_per_tick.push_back(seconds * 1e3 / ticks);
+            ns_per_update.push_back(updates > 0 ? seconds * 1e9 / static_cast<double>(updates) : 0.0);
+            final_pop = ocean.getPopulationStats();
+        }
+        std::printf("%-12s %14.3f %16.1f %12d\n",
+                    mode == DispatchMode::VIRTUAL ? "virtual" : "by-species",
+                    Bench::median(ms_per_tick), Bench::median(ns_per_update), final_pop.total());
+    }
+    return 0;
+}
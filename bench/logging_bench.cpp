@@ -0,0 +1,59 @@
+#include "bench_common.hpp"
+
+#include <cstdlib>
+
+#include "utils/event_log.hpp"
+#include "utils/logger.hpp"
+
+namespace {
+
+double msPerTick(const std::vector<Bench::Placement>& placements, int size, int ticks) {
+    Ocean ocean(size, size);
+    Bench::place(ocean, placements);
+    Bench::Stopwatch watch;
+    for (int t = 0; t < ticks; ++t) {
+        ocean.tick();
+    }
+    return watch.elapsedSeconds() * 1e3 / ticks;
+}
+
+}
+
+// Tick time with the log file closed (every debug/info call filtered out),
+// writing info lines to LOG_TO_FILE as the game does, and recording the
+// binary event stream instead. When info is compiled out
+// (OCEAN_LOG_COMPILE_MIN_LEVEL >= 2, the Release default) the file row would
+// time an empty log, so it is skipped.
+// Usage: OceanLoggingBench [size=256] [ticks=30] [repeats=5]
+int main(int argc, char** argv) {
+    const int size = argc > 1 ? std::atoi(argv[1]) : 256;
+    const int ticks = argc > 2 ? std::atoi(argv[2]) : 30;
+    const int repeats = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    std::printf("grid %dx%d, %d ticks, %d repeats, compile-time min level %d\n",
+                size, size, ticks, repeats, OCEAN_LOG_COMPILE_MIN_LEVEL);
+
+    const std::vector<Bench::Placement> placements = Bench::randomPlacements(size, size);
+    std::vector<double> disabled;
+    std::vector<double> to_file;
+    std::vector<double> events;
+    for (int rep = 0; rep < repeats; ++rep) {
+        disabled.push_back(msPerTick(placements, size, ticks));
+        if constexpr (LogLevel::INFO >= COMPILE_MIN_LOG_LEVEL) {
+            Logger::init();
+            to_file.push_back(msPerTick(placements, size, ticks));
+            Logger::shutdown();
+        }
+        EventLog::open("simulation.events");
+        events.push_back(msPerTick(placements, size, ticks));
+        EventLog::close();
+    }
+    std::printf("%-20s %10.3f ms/tick\n", "logging disabled", Bench::median(disabled));
+    if (to_file.empty()) {
+        std::printf("%-20s %10s (info compiled out; rebuild with OCEAN_LOG_COMPILE_MIN_LEVEL=1)\n", "info to file", "skipped");
+    } else {
+        std::printf("%-20s %10.3f ms/tick\n", "info to file", Bench::median(to_file));
+    }
+    std::printf("%-20s %10.3f ms/tick\n", "binary events", Bench::median(events));
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "bench_common.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+
+struct Series {
+    std::vector<PopulationStats> samples;
+    double seconds = 0.0;
+};
+
+Series run(const std::vector<Bench::Placement>& placements, int size, int ticks, int threads) {
+    Ocean ocean(size, size);
+    ocean.setThreadCount(threads);
+    Bench::place(ocean, placements);
+
+    Series series;
+    for (int t = 0; t < ticks; ++t) {
+        Bench::Stopwatch watch;
+        ocean.tick();
+        series.seconds += watch.elapsedSeconds();
+        series.samples.push_back(ocean.getPopulationStats());
+    }
+    return series;
+}
+
+void printSummary(const char* label, const Series& series, int ticks) {
+    double mean[3] = {0, 0, 0};
+    double var[3] = {0, 0, 0};
+    for (const PopulationStats& p : series.samples) {
+        mean[0] += p.algae; mean[1] += p.herbivores; mean[2] += p.predators;
+    }
+    for (double& m : mean) m /= series.samples.size();
+    for (const PopulationStats& p : series.samples) {
+        const double v[3] = {p.algae - mean[0], p.herbivores - mean[1], p.predators - mean[2]};
+        for (int i = 0; i < 3; ++i) var[i] += v[i] * v[i];
+    }
+    for (double& v : var) v = std::sqrt(v / series.samples.size());
+    std::printf("%-9s %10.3f ms/tick | algae %9.1f +- %7.1f | herbivores %8.1f +- %6.1f | predators %7.1f +- %5.1f\n",
+                label, series.seconds * 1e3 / ticks, mean[0], var[0], mean[1], var[1], mean[2], var[2]);
+}
+
+}
+
+// Runs the same initial ocean through the serial and the tile-parallel tick
+// and compares population trajectories.
+// Usage: OceanParallelBench [size=512] [ticks=100] [threads=0 (all)]
+int main(int argc, char** argv) {
+    const int size = argc > 1 ? std::atoi(argv[1]) : 512;
+    const int ticks = argc > 2 ? std::atoi(argv[2]) : 100;
+    const int threads = argc > 3 ? std::atoi(argv[3]) : 0;
+
+    const std::vector<Bench::Placement> placements = Bench::randomPlacements(size, size);
+    const Series serial = run(placements, size, ticks, 1);
+    const Series parallel = run(placements, size, ticks, threads);
+
+    std::printf("grid %dx%d, %d ticks\n", size, size, ticks);
+    std::printf("%6s | %21s | %21s | %21s\n", "tick", "algae (ser/par)", "herbivores (ser/par)", "predators (ser/par)");
+    const int step = std::max(1, ticks / 10);
+    for (int t = step - 1; t < ticks; t += step) {
+        const PopulationStats& s = serial.samples[t];
+        const PopulationStats& p = parallel.samples[t];
+        std::printf("%6d | %10d %10d | %10d %10d | %10d %10d\n",
+                    t + 1, s.algae, p.algae, s.herbivores, p.herbivores, s.predators, p.predators);
+    }
+    printSummary("serial", serial, ticks);
+    printSummary("parallel", parallel, ticks);
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include "bench_common.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "neighbor_list.hpp"
+
+namespace {
+
+// The previous Random path: a thread-local mt19937 and a fresh distribution per call.
+std::mt19937& legacyGenerator() {
+    thread_local std::mt19937 generator(12345u);
+    return generator;
+}
+
+int legacyGetInt(int min, int max) {
+    std::uniform_int_distribution<int> distribution(min, max);
+    return distribution(legacyGenerator());
+}
+
+NeighborList fullNeighborhood() {
+    NeighborList cells;
+    for (int i = 0; i < NeighborList::CAPACITY; ++i) {
+        cells.push_back({i / 3, i % 3});
+    }
+    return cells;
+}
+
+template<typename Fn>
+void measure(const char* label, long long draws, int repeats, Fn&& fn) {
+    std::vector<double> samples;
+    std::uint64_t sink = 0;
+    for (int rep = 0; rep < repeats; ++rep) {
+        Bench::Stopwatch watch;
+        for (long long i = 0; i < draws; ++i) {
+            sink += static_cast<std::uint64_t>(fn());
+        }
+        samples.push_back(watch.elapsedSeconds() * 1e9 / static_cast<double>(draws));
+    }
+    std::printf("%-28s %10.2f ns/call   (checksum %llu)\n", label, Bench::median(samples),
+                static_cast<unsigned long long>(sink));
+}
+
+}
+
+// Compares the old mt19937 + per-call distribution path with the
+// xoshiro256** engine behind Random.
+// Usage: OceanRandomBench [draws=20000000] [repeats=5]
+int main(int argc, char** argv) {
+    const long long draws = argc > 1 ? std::atoll(argv[1]) : 20000000;
+    const int repeats = argc > 2 ? std::atoi(argv[2]) : 5;
+    Random::seed(12345);
+
+    std::printf("%lld draws, %d repeats\n", draws, repeats);
+
+    measure("mt19937 getInt(1,100)", draws, repeats, [] { return legacyGetInt(1, 100); });
+    measure("Random::getInt(1,100)", draws, repeats, [] { return Random::getInt(1, 100); });
+
+    SplitMix64 splitmix(12345);
+    measure("SplitMix64::nextInt(1,100)", draws, repeats, [&] { return splitmix.nextInt(1, 100); });
+
+    measure("mt19937 getDouble", draws, repeats, [] {
+        std::uniform_real_distribution<double> distribution(0.0, 1.0);
+        return distribution(legacyGenerator()) < 0.5;
+    });
+    measure("Random::getDouble", draws, repeats, [] { return Random::getDouble(0.0, 1.0) < 0.5; });
+
+    NeighborList cells = fullNeighborhood();
+    measure("mt19937 shuffle + [0] of 8", draws / 4, repeats, [&] {
+        std::shuffle(cells.begin(), cells.end(), legacyGenerator());
+        return cells[0].first;
+    });
+    measure("Random::shuffle + [0] of 8", draws / 4, repeats, [&] {
+        Random::shuffle(cells);
+        return cells[0].first;
+    });
+    measure("Random::pick of 8", draws, repeats, [&] { return Random::pick(cells).first; });
+    return 0;
+}
@@ -1,12 +1,16 @@
 #pragma once
 #include "entity.hpp"
 
-class Algae : public Entity {
+class Algae final : public Entity {
 public:
+    static constexpr EntityType TYPE = EntityType::ALGAE;
+
     Algae();
     ~Algae() override = default;
 
     void update(Ocean& ocean, int r, int c) override;
+    Intent planUpdate(const Ocean& ocean, int r, int c, SplitMix64& rng) const override;
+    void applyUpdate(Ocean& ocean, int r, int c, const Intent& intent) override;
     char getSymbol() const override;
     EntityType getType() const override;
 };
\ No newline at end of file
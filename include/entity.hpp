@@ -1,14 +1,26 @@
 #pragma once
 
+#include <cstdint>
+#include <utility>
+
 class Ocean; 
+class SplitMix64;
 
-enum class EntityType {
+enum class EntityType : std::uint8_t {
     SAND,
     ALGAE,
     HERBIVORE,
     PREDATOR
 };
 
+// What an entity wants to do this tick in UpdateMode::INTENT. Cells are
+// {-1, -1} when unused; an entity that eats moves into the eaten cell.
+struct Intent {
+    std::pair<int, int> eat = {-1, -1};
+    std::pair<int, int> spawn = {-1, -1};
+    std::pair<int, int> move = {-1, -1};
+};
+
 class Entity {
 public:
     virtual ~Entity() = default;
@@ -16,4 +28,13 @@ public:
     virtual char getSymbol() const = 0;
     virtual EntityType getType() const = 0;
     virtual bool isDead() const { return false; }
+    virtual int getEnergy() const { return 0; }
+    virtual int getAge() const { return 0; }
+
+    // Two-phase update: planUpdate() decides from a read-only ocean (possibly
+    // on a worker thread), applyUpdate() then executes the plan on the live
+    // grid, where a cell taken by a higher-priority entity makes that part of
+    // the plan fail. Entities without a plan fall back to update().
+    virtual Intent planUpdate(const Ocean& /*ocean*/, int /*r*/, int /*c*/, SplitMix64& /*rng*/) const { return {}; }
+    virtual void applyUpdate(Ocean& ocean, int r, int c, const Intent& /*intent*/) { update(ocean, r, c); }
 };
\ No newline at end of file
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "entity.hpp"
+
+class EntityPool;
+
+// Returns pooled entities to their slab; entities created with plain
+// std::make_unique (pool_ == nullptr) are deleted as before.
+class EntityDeleter {
+public:
+    EntityDeleter() = default;
+    explicit EntityDeleter(EntityPool* pool) : pool_(pool) {}
+    template<typename T>
+    EntityDeleter(const std::default_delete<T>&) {}
+
+    void operator()(Entity* entity) const;
+
+private:
+    EntityPool* pool_ = nullptr;
+};
+
+using EntityPtr = std::unique_ptr<Entity, EntityDeleter>;
+
+struct PoolStats {
+    size_t live = 0;
+    size_t free = 0;
+    size_t high_water = 0;
+    size_t capacity = 0;
+};
+
+class EntityPool {
+public:
+    static constexpr size_t SLOTS_PER_CHUNK = 1024;
+
+    EntityPool();
+    ~EntityPool() = default;
+
+    EntityPool(const EntityPool&) = delete;
+    EntityPool& operator=(const EntityPool&) = delete;
+
+    template<typename T, typename... Args>
+    EntityPtr make(Args&&... args) {
+        static_assert(std::is_base_of<Entity, T>::value, "EntityPool::make requires an Entity subtype");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "over-aligned entities are not supported");
+        void* slot = allocateSlot(T::TYPE);
+        try {
+            return EntityPtr(new (slot) T(std::forward<Args>(args)...), EntityDeleter(this));
+        } catch (...) {
+            releaseSlot(T::TYPE, slot);
+            throw;
+        }
+    }
+
+    void destroy(Entity* entity);
+    void reserve(EntityType type, size_t slots);
+    PoolStats getStats(EntityType type) const;
+
+    // While concurrent, allocations and releases from several threads are
+    // serialized by a mutex; otherwise the pool takes no lock.
+    void setConcurrent(bool concurrent);
+
+private:
+    class Slab {
+    public:
+        explicit Slab(size_t slot_size = 0);
+
+        void* allocate();
+        void release(void* slot);
+        void reserve(size_t slots);
+        PoolStats getStats() const;
+
+    private:
+        size_t slot_size_;
+        std::vector<std::unique_ptr<unsigned char[]>> chunks_;
+        std::vector<void*> free_list_;
+        size_t live_ = 0;
+        size_t high_water_ = 0;
+
+        void grow();
+    };
+
+    static constexpr int SLAB_COUNT = 4;
+    Slab slabs_[SLAB_COUNT];
+    bool concurrent_ = false;
+    std::mutex mutex_;
+
+    void* allocateSlot(EntityType type);
+    void releaseSlot(EntityType type, void* slot);
+
+    Slab& slabFor(EntityType type);
+    const Slab& slabFor(EntityType type) const;
+};
@@ -18,15 +18,28 @@ namespace Config {
     const int HERBIVORE_CRITICAL_ENERGY_THRESHOLD = 70;
 }
 
-class HerbivoreFish : public Entity {
+class HerbivoreFish final : public Entity {
 public:
+    static constexpr EntityType TYPE = EntityType::HERBIVORE;
+
     explicit HerbivoreFish(int initial_energy = Config::HERBIVORE_INITIAL_ENERGY);
     ~HerbivoreFish() override = default;
 
     void update(Ocean& ocean, int r, int c) override;
+    Intent planUpdate(const Ocean& ocean, int r, int c, SplitMix64& rng) const override;
+    void applyUpdate(Ocean& ocean, int r, int c, const Intent& intent) override;
     char getSymbol() const override;
     EntityType getType() const override;
     bool isDead() const override;
+    int getEnergy() const override;
+    int getAge() const override;
+
+    // True when a herbivore with this energy steers towards the nearest algae.
+    static bool isSeekingFood(int energy);
+    // Species rules behind isDead() and the hungry 'h' symbol, usable from
+    // the planes without an Entity.
+    static bool isDying(int energy, int age);
+    static bool isStarving(int energy);
 
 private:
     int energy_;
@@ -35,4 +48,6 @@ private:
     bool tryToEat(Ocean& ocean, int current_r, int current_c);
     bool tryToReproduce(Ocean& ocean, int current_r, int current_c);
     void intelligentMove(Ocean& ocean, int current_r, int current_c);
+    std::pair<int, int> planMove(const Ocean& ocean, int current_r, int current_c, int energy,
+                                 std::pair<int, int> reserved, SplitMix64& rng) const;
 };
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+// Fixed-capacity, inline list of the (at most 8) cells around a position.
+// Used by the allocation-free Ocean neighbor queries.
+class NeighborList {
+public:
+    static constexpr int CAPACITY = 8;
+
+    using value_type = std::pair<int, int>;
+    using iterator = value_type*;
+    using const_iterator = const value_type*;
+
+    void push_back(const value_type& cell) {
+        if (size_ >= CAPACITY) {
+            throw std::length_error("NeighborList::push_back: capacity exceeded.");
+        }
+        cells_[size_++] = cell;
+    }
+
+    void clear() { size_ = 0; }
+    int size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    value_type& operator[](int i) { return cells_[i]; }
+    const value_type& operator[](int i) const { return cells_[i]; }
+
+    iterator begin() { return cells_.data(); }
+    iterator end() { return cells_.data() + size_; }
+    const_iterator begin() const { return cells_.data(); }
+    const_iterator end() const { return cells_.data() + size_; }
+
+private:
+    std::array<value_type, CAPACITY> cells_{};
+    int size_ = 0;
+};
@@ -1,9 +1,86 @@
 #pragma once
 
+#include <cstdint>
+#include <iosfwd>
 #include <memory>
 #include <vector>
 #include <utility>
 #include "entity.hpp" 
+#include "entity_pool.hpp"
+#include "neighbor_list.hpp"
+#include "utils/tick_profiler.hpp"
+
+// VIRTUAL updates every entity through Entity::update in one shuffled pass.
+// BY_SPECIES groups the closed species set and runs each group in its own
+// shuffled, non-virtual loop (algae, then herbivores, then predators).
+enum class DispatchMode {
+    VIRTUAL,
+    BY_SPECIES
+};
+
+// Per-tick flow fields answer getDirectionToNearestTarget for hungry fish
+// with one lookup instead of a sight-window scan. Fields are built from the
+// grid at the start of the tick, in time linear in the grid area, and pick
+// the target the direct search would (nearest by Euclidean distance, ties in
+// row-major order). Until the grid first changes they are exact, which
+// covers the planning phase of an INTENT tick; after that, cells without a
+// target in sight and targets eaten since fall back to the direct search,
+// but a target added during the tick closer than the field's is not seen.
+// AUTO builds a field only when the hungry seekers would scan more cells
+// than building it costs, roughly when they fill a third of the grid
+// (OceanBench --filter flow-field measures the break-even).
+enum class FlowFieldMode {
+    OFF,
+    AUTO,
+    ALWAYS
+};
+
+// IN_PLACE updates entities one after another on the live grid (serially or
+// tile-parallel). INTENT is a synchronous two-phase update: every entity
+// plans against the grid as it was at the start of the tick, in parallel,
+// then the plans are applied in a seeded pseudo-random priority order that
+// settles conflicts over the same cell.
+enum class UpdateMode {
+    IN_PLACE,
+    INTENT
+};
+
+// One byte per cell (Ocean::getRenderStates): the EntityType in the low two
+// bits, RENDER_HUNGRY for a fish drawn hungry and RENDER_DYING for a dead
+// entity still waiting for the end-of-tick sweep.
+constexpr std::uint8_t RENDER_TYPE_MASK = 0x03;
+constexpr std::uint8_t RENDER_HUNGRY = 0x04;
+constexpr std::uint8_t RENDER_DYING = 0x08;
+constexpr int RENDER_STATE_COUNT = 16;
+
+inline EntityType renderStateType(std::uint8_t state) {
+    return static_cast<EntityType>(state & RENDER_TYPE_MASK);
+}
+
+// Same symbols as Entity::getSymbol, with '.' for an empty cell.
+inline char renderStateSymbol(std::uint8_t state) {
+    static constexpr char SYMBOLS[RENDER_STATE_COUNT] = {
+        '.', 'A', 'H', 'P',
+        '.', 'A', 'h', 'p',
+        '.', 'x', 'x', 'x',
+        '.', 'x', 'x', 'x',
+    };
+    return SYMBOLS[state & (RENDER_STATE_COUNT - 1)];
+}
+
+// Entity counts after `tick` completed ticks. The energy totals are the
+// summed energy of each species and stay 0 unless energy tracking is on.
+struct PopulationStats {
+    unsigned long long tick = 0;
+    int algae = 0;
+    int herbivores = 0;
+    int predators = 0;
+    long long algae_energy = 0;
+    long long herbivore_energy = 0;
+    long long predator_energy = 0;
+
+    int total() const { return algae + herbivores + predators; }
+};
 
 class Ocean {
 public:
@@ -16,9 +93,16 @@ public:
     Ocean(Ocean&& other) noexcept;
     Ocean& operator=(Ocean&& other) noexcept;
 
-    bool addEntity(std::unique_ptr<Entity> entity, int r, int c);
+    // Entities are allocated from a per-Ocean slab pool. Pooled entities that
+    // are removed from the grid must be released before the Ocean is destroyed.
+    template<typename T, typename... Args>
+    EntityPtr createEntity(Args&&... args) {
+        return getPool().make<T>(std::forward<Args>(args)...);
+    }
+
+    bool addEntity(EntityPtr entity, int r, int c);
     Entity* getEntity(int r, int c) const;
-    std::unique_ptr<Entity> removeEntity(int r, int c);
+    EntityPtr removeEntity(int r, int c);
     bool moveEntity(int r_from, int c_from, int r_to, int c_to);
 
     int getRows() const;
@@ -27,12 +111,104 @@ public:
     void display() const;
     void tick(); 
 
+    void setDispatchMode(DispatchMode mode);
+    DispatchMode getDispatchMode() const;
+
+    void setFlowFieldMode(FlowFieldMode mode);
+    FlowFieldMode getFlowFieldMode() const;
+
+    // With more than one thread, tick() splits the grid into square tiles
+    // (at least PREDATOR_SIGHT_RADIUS + 2 cells wide) colored in a 2x2
+    // checkerboard and updates same-colored tiles concurrently. A count of 0
+    // uses every hardware thread; 1 is the serial tick.
+    void setThreadCount(int thread_count);
+    int getThreadCount() const;
+    void setTileSize(int tile_size);
+    int getTileSize() const;
+
+    // Planning in UpdateMode::INTENT uses the thread count above; the seed
+    // makes INTENT ticks reproducible for a given starting grid.
+    void setUpdateMode(UpdateMode mode);
+    UpdateMode getUpdateMode() const;
+    void setIntentSeed(std::uint64_t seed);
+
+    unsigned long long getTickCount() const;
+
+    // Population counters are maintained by every add, remove and sweep, so
+    // these are O(1) and safe to poll every tick on any grid size. Each tick
+    // appends its end-of-tick stats to a history of the last `ticks` ticks
+    // (1024 by default, 0 disables it).
+    PopulationStats getPopulationStats() const;
+    int getPopulation(EntityType type) const;
+    void setEnergyTracking(bool enabled);
+    bool isEnergyTracking() const;
+    long long getTotalEnergy(EntityType type) const;
+    void setPopulationHistory(size_t ticks);
+    std::vector<PopulationStats> getPopulationHistory() const;
+
+    // Row-major (r * cols + c) render state of every cell, kept current by
+    // every grid change; valid until the Ocean is destroyed. Read it between
+    // ticks, not while one is running.
+    const std::vector<std::uint8_t>& getRenderStates() const;
+
+    // With dirty tracking on, every add, remove, move or update that changes
+    // a cell's render state records the cell; a renderer repaints
+    // getDirtyCells() (row-major indices, each listed once) and then clears
+    // the set. Cells accumulate across ticks until cleared. Off by default.
+    void setDirtyTracking(bool enabled);
+    bool isDirtyTracking() const;
+    const std::vector<int>& getDirtyCells() const;
+    void clearDirtyCells();
+
+    // Opt-in per-tick profiling: phase times, per-species update time and
+    // grid operation counts of each tick, kept for the last `ticks` ticks
+    // (TickProfiler::DEFAULT_WINDOW by default). Needs a build with
+    // OCEAN_ENABLE_PROFILER; otherwise enabling it only logs a warning and
+    // tick() carries no profiling code at all.
+    void setProfilingEnabled(bool enabled);
+    bool isProfilingEnabled() const;
+    void setProfileWindow(size_t ticks);
+    void clearTickProfiles();
+    TickProfile getLastTickProfile() const;
+    std::vector<TickProfile> getTickProfiles() const;
+    // Rolling histogram of the recorded window; see TickProfiler::dump.
+    void dumpTickProfile(std::ostream& out) const;
+
     bool isValidCoordinate(int r, int c) const;
     std::vector<std::pair<int, int>> getEmptyAdjacentCells(int r, int c) const;
     std::vector<std::pair<int, int>> getAdjacentCellsOfType(int r, int c, EntityType type) const;
+
+    // Allocation-free variants: same cells in the same order as the vector
+    // overloads, written into a fixed-capacity inline list or passed to a
+    // visitor called as visit(r, c).
+    void getEmptyAdjacentCells(int r, int c, NeighborList& out) const;
+    void getAdjacentCellsOfType(int r, int c, EntityType type, NeighborList& out) const;
+
+    template<typename Visitor>
+    void forEachEmptyAdjacentCell(int r, int c, Visitor&& visit) const {
+        NeighborList cells;
+        getEmptyAdjacentCells(r, c, cells);
+        for (const auto& cell : cells) {
+            visit(cell.first, cell.second);
+        }
+    }
+
+    template<typename Visitor>
+    void forEachAdjacentCellOfType(int r, int c, EntityType type, Visitor&& visit) const {
+        NeighborList cells;
+        getAdjacentCellsOfType(r, c, type, cells);
+        for (const auto& cell : cells) {
+            visit(cell.first, cell.second);
+        }
+    }
     std::pair<int, int> getDirectionToNearestTarget(int start_r, int start_c, EntityType target_type, int radius) const;
 
+    PoolStats getPoolStats(EntityType type) const;
+    void reservePool(EntityType type, size_t slots);
+
 private:
     class OceanImpl; 
     std::unique_ptr<OceanImpl> pImpl_; 
+
+    EntityPool& getPool();
 };
\ No newline at end of file
@@ -18,15 +18,28 @@ namespace Config {
     const int PREDATOR_CRITICAL_ENERGY_THRESHOLD = 90; 
 }
 
-class PredatorFish : public Entity {
+class PredatorFish final : public Entity {
 public:
+    static constexpr EntityType TYPE = EntityType::PREDATOR;
+
     explicit PredatorFish(int initial_energy = Config::PREDATOR_INITIAL_ENERGY);
     ~PredatorFish() override = default;
 
     void update(Ocean& ocean, int r, int c) override;
+    Intent planUpdate(const Ocean& ocean, int r, int c, SplitMix64& rng) const override;
+    void applyUpdate(Ocean& ocean, int r, int c, const Intent& intent) override;
     char getSymbol() const override;
     EntityType getType() const override;
     bool isDead() const override;
+    int getEnergy() const override;
+    int getAge() const override;
+
+    // True when a predator with this energy steers towards the nearest herbivore.
+    static bool isHunting(int energy);
+    // Species rules behind isDead() and the hungry 'p' symbol, usable from
+    // the planes without an Entity.
+    static bool isDying(int energy, int age);
+    static bool isStarving(int energy);
 
 private:
     int energy_;
@@ -35,4 +48,6 @@ private:
     bool tryToEat(Ocean& ocean, int current_r, int current_c);
     bool tryToReproduce(Ocean& ocean, int current_r, int current_c);
     void huntOrExplore(Ocean& ocean, int current_r, int current_c); 
+    std::pair<int, int> planMove(const Ocean& ocean, int current_r, int current_c, int energy,
+                                 std::pair<int, int> reserved, SplitMix64& rng) const;
 };
\ No newline at end of file
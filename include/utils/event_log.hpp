@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "entity.hpp"
+
+// Binary alternative to the text log for population dynamics: each event is
+// one fixed-size record appended to a per-thread buffer, with no formatting
+// on the simulation thread. Decode with OceanEventDecode.
+enum class EventType : std::uint8_t {
+    SPAWN, // algae seeded a neighboring cell (target)
+    BIRTH, // fish placed offspring at target; energy is the parent's after the cost
+    EAT,   // actor ate the entity at target and moved there
+    MOVE,  // actor moved to target
+    DEATH  // dead actor removed at the end of the tick
+};
+
+inline const char* eventTypeToString(EventType type) {
+    switch (type) {
+        case EventType::SPAWN: return "spawn";
+        case EventType::BIRTH: return "birth";
+        case EventType::EAT:   return "eat";
+        case EventType::MOVE:  return "move";
+        case EventType::DEATH: return "death";
+        default:               return "unknown";
+    }
+}
+
+// Native byte order; the file header records the record size so a decoder
+// can reject streams from an incompatible build.
+struct EventRecord {
+    std::uint32_t tick;
+    std::uint8_t type;    // EventType
+    std::uint8_t species; // EntityType of the actor
+    std::uint16_t reserved;
+    std::int32_t r;
+    std::int32_t c;
+    std::int32_t target_r; // -1 when the event has no target
+    std::int32_t target_c;
+    std::int32_t energy;
+};
+static_assert(sizeof(EventRecord) == 28, "EventRecord layout is part of the file format");
+
+struct EventLogHeader {
+    char magic[4];          // "OCEV"
+    std::uint32_t version;
+    std::uint32_t record_size;
+};
+
+constexpr char EVENT_LOG_MAGIC[4] = {'O', 'C', 'E', 'V'};
+constexpr std::uint32_t EVENT_LOG_VERSION = 1;
+
+class EventLog {
+public:
+    // Starts a new stream at path; returns false if it cannot be opened.
+    static bool open(const std::string& path);
+    // Flushes every thread's buffer and closes the stream. Like
+    // Logger::shutdown, must not race with ticks still running.
+    static void close();
+
+    static bool isEnabled() {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    // Stamped into the following records of the calling thread only, so
+    // oceans ticking on different threads keep their own ticks. Ocean sets
+    // it at the start of each tick and in every tile task it hands to its
+    // pool threads.
+    static void setTick(std::uint32_t tick) {
+        tick_ = tick;
+    }
+
+    static void emit(EventType type, EntityType species, int r, int c, int target_r, int target_c, int energy) {
+        if (isEnabled()) {
+            append(type, species, r, c, target_r, target_c, energy);
+        }
+    }
+
+private:
+    static void append(EventType type, EntityType species, int r, int c, int target_r, int target_c, int energy);
+
+    inline static std::atomic<bool> enabled_{false};
+    inline static thread_local std::uint32_t tick_ = 0;
+};
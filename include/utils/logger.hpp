@@ -1,15 +1,29 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <chrono>
 #include <iomanip> 
 #include <sstream> 
 #include <fstream> 
+#include <mutex>
 
 
 #define LOG_TO_FILE "simulation.log" 
 
+// Calls below this level (0 = DEBUG ... 3 = ERROR) compile to nothing.
+// Release builds drop debug and info output unless overridden.
+#ifndef OCEAN_LOG_COMPILE_MIN_LEVEL
+#ifdef NDEBUG
+#define OCEAN_LOG_COMPILE_MIN_LEVEL 2
+#else
+#define OCEAN_LOG_COMPILE_MIN_LEVEL 0
+#endif
+#endif
+
 enum class LogLevel {
     DEBUG,
     INFO,
@@ -28,72 +42,193 @@ inline std::string logLevelToString(LogLevel level) {
     }
 }
 
+// What the asynchronous file sink does when its queue is full.
+enum class LogOverflowPolicy {
+    DROP,            // discard the message
+    DROP_AND_REPORT, // discard it and write "dropped N messages" once there is room
+    BLOCK            // wait for the writer thread to catch up
+};
+
+enum class LogTimestampPrecision {
+    SECONDS,
+    MILLISECONDS,
+    MICROSECONDS
+};
+
+struct LogOptions {
+    // File lines collect in a per-thread buffer that is handed in batches
+    // through a lock-free queue to a writer thread; with async off they are
+    // written by the caller under a mutex.
+    bool async = true;
+    std::size_t queue_capacity = 4096; // batches
+    LogOverflowPolicy overflow = LogOverflowPolicy::DROP_AND_REPORT;
+    LogTimestampPrecision timestamp_precision = LogTimestampPrecision::SECONDS;
+};
+
+constexpr LogLevel COMPILE_MIN_LOG_LEVEL = static_cast<LogLevel>(OCEAN_LOG_COMPILE_MIN_LEVEL);
 constexpr LogLevel MIN_LOG_LEVEL_CONSOLE = LogLevel::WARNING;
+// Serializes writes so that Ocean can log from parallel tick workers.
+extern std::mutex log_output_mutex;
 #ifdef LOG_TO_FILE
 constexpr LogLevel MIN_LOG_LEVEL_FILE = LogLevel::INFO;
 extern std::ofstream log_file_stream;
+extern std::atomic<bool> log_file_enabled;
 #endif
 
 
 class Logger {
 public:
-    static void init() {
-    #ifdef LOG_TO_FILE
-        log_file_stream.open(LOG_TO_FILE, std::ios::app);
-        if (!log_file_stream.is_open()) {
-            std::cerr << "Failed to open log file: " << LOG_TO_FILE << std::endl;
-        } else {
-            log(LogLevel::INFO, "Logger initialized. Logging to file: " LOG_TO_FILE);
-        }
-    #endif
-        log(LogLevel::INFO, "Logger initialized for console output.");
-    }
+    static void init(const LogOptions& options = LogOptions());
+    static void shutdown();
 
-    static void shutdown() {
-    #ifdef LOG_TO_FILE
-        if (log_file_stream.is_open()) {
-            log(LogLevel::INFO, "Logger shutting down.");
-            log_file_stream.close();
+    // Hands the calling thread's buffered lines to the writer. Threads that
+    // log from inside a tick call this when their share of the work is done.
+    static void flushThreadBuffer();
+    // Flushes the calling thread and marks a tick boundary: every line handed
+    // over before it is written, ordered by time, before any line after it.
+    // Boundaries are process-wide, not per ocean: with several oceans ticking
+    // at once, each one's boundary also closes the others' open segment, so
+    // lines stay ordered by time within a segment but one tick's lines can
+    // be split across segments. Lines of a thread that went idle are picked
+    // up by the writer within about 25 ms, so with shorter ticks they can
+    // land in a later segment than lines logged after them.
+    static void endTick();
+
+    // Messages discarded by the async sink since init().
+    static std::uint64_t getDroppedCount();
+
+    // True if a message at this level would reach the console or the file.
+    static bool isEnabled(LogLevel level) {
+        if (level < COMPILE_MIN_LOG_LEVEL) {
+            return false;
+        }
+        if (level >= MIN_LOG_LEVEL_CONSOLE) {
+            return true;
         }
+    #ifdef LOG_TO_FILE
+        return level >= MIN_LOG_LEVEL_FILE && log_file_enabled.load(std::memory_order_relaxed);
+    #else
+        return false;
     #endif
     }
 
     template<typename... Args>
     static void log(LogLevel level, const Args&... args) {
+        if (!isEnabled(level)) {
+            return;
+        }
         std::ostringstream oss;
         (oss << ... << args); 
-        std::string message = oss.str();
+        write(level, oss.str());
+    }
 
-        if (level >= MIN_LOG_LEVEL_CONSOLE) {
-            auto now = std::chrono::system_clock::now();
-            auto in_time_t = std::chrono::system_clock::to_time_t(now);
-            #ifdef _MSC_VER 
-            std::tm timeinfo_tm;
-            localtime_s(&timeinfo_tm, &in_time_t);
-            std::cout << std::put_time(&timeinfo_tm, "%Y-%m-%d %H:%M:%S") << " "
-                      << logLevelToString(level) << " " << message << std::endl;
-            #else
-            std::cout << std::put_time(std::localtime(&in_time_t), "%Y-%m-%d %H:%M:%S") << " " << logLevelToString(level) << " " << message << std::endl;
-            #endif
+    template<typename... Args> static void debug(const Args&... args) {
+        if constexpr (LogLevel::DEBUG >= COMPILE_MIN_LOG_LEVEL) log(LogLevel::DEBUG, args...);
+    }
+    template<typename... Args> static void info(const Args&... args) {
+        if constexpr (LogLevel::INFO >= COMPILE_MIN_LOG_LEVEL) log(LogLevel::INFO, args...);
+    }
+    template<typename... Args> static void warn(const Args&... args) {
+        if constexpr (LogLevel::WARNING >= COMPILE_MIN_LOG_LEVEL) log(LogLevel::WARNING, args...);
+    }
+    template<typename... Args> static void error(const Args&... args) { log(LogLevel::LOG_ERROR, args...); }
+
+    // Writes the pending "suppressed N similar messages" lines of every
+    // rate-limited site; called by shutdown().
+    static void flushSuppressed();
+
+private:
+    static void write(LogLevel level, std::string message);
+};
+
+// State of one sampled or rate-limited log call site, see LOG_EVERY_N and
+// LOG_RATE_LIMITED. A suppressed call costs one or two relaxed atomic
+// increments, plus a clock read at a capped site, so that the cap is lifted
+// as soon as the interval has passed however rarely the site is reached.
+// The summary of suppressed calls is written when the next interval starts.
+class LogSite {
+public:
+    LogSite(LogLevel level, const char* file, int line, std::uint32_t every_n, std::uint32_t max_per_interval,
+            std::chrono::milliseconds interval = std::chrono::seconds(1))
+        : level_(level), file_(file), line_(line), every_n_(every_n), max_per_interval_(max_per_interval),
+          interval_ms_(interval.count()) {}
+
+    bool allow() {
+        if (every_n_ > 1) {
+            // Skipped samples are only counted, in bulk, when the next one passes.
+            const std::uint64_t call = calls_.fetch_add(1, std::memory_order_relaxed);
+            if (call % every_n_ != 0) {
+                return false;
+            }
+            if (call > 0) {
+                suppress(every_n_ - 1);
+            }
+        }
+        if (max_per_interval_ != 0 && passed_.load(std::memory_order_relaxed) >= max_per_interval_) {
+            suppress();
+            if (!startNewInterval(1)) {
+                return false;
+            }
+        } else {
+            startNewInterval(0);
+        }
+        if (max_per_interval_ == 0 || passed_.fetch_add(1, std::memory_order_relaxed) < max_per_interval_) {
+            return true;
         }
+        suppress();
+        return false;
+    }
 
-    #ifdef LOG_TO_FILE
-        if (log_file_stream.is_open() && level >= MIN_LOG_LEVEL_FILE) {
-            auto now = std::chrono::system_clock::now();
-            auto in_time_t = std::chrono::system_clock::to_time_t(now);
-            #ifdef _MSC_VER
-            std::tm timeinfo_tm_file;
-            localtime_s(&timeinfo_tm_file, &in_time_t);
-            log_file_stream << std::put_time(&timeinfo_tm_file, "%Y-%m-%d %H:%M:%S") << " " << logLevelToString(level) << " " << message << std::endl;
-            #else
-            log_file_stream << std::put_time(std::localtime(&in_time_t), "%Y-%m-%d %H:%M:%S") << " " << logLevelToString(level) << " " << message << std::endl;
-            #endif
+    // Logs "suppressed N similar messages" if any, not counting `exclude`
+    // calls that were counted as suppressed but let through after all.
+    void reportSuppressed(std::uint64_t exclude = 0);
+
+private:
+    void suppress(std::uint64_t count = 1) {
+        const std::uint64_t previous = suppressed_.fetch_add(count, std::memory_order_relaxed);
+        if (previous == 0 && !registered_.exchange(true, std::memory_order_relaxed)) {
+            registerSite();
         }
-    #endif
     }
 
-    template<typename... Args> static void debug(const Args&... args) { log(LogLevel::DEBUG, args...); }
-    template<typename... Args> static void info(const Args&... args) { log(LogLevel::INFO, args...); }
-    template<typename... Args> static void warn(const Args&... args) { log(LogLevel::WARNING, args...); }
-    template<typename... Args> static void error(const Args&... args) { log(LogLevel::LOG_ERROR, args...); }
-};
\ No newline at end of file
+    bool startNewInterval(std::uint64_t exclude) {
+        const long long now = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        long long start = interval_start_.load(std::memory_order_relaxed);
+        if (now - start < interval_ms_ ||
+            !interval_start_.compare_exchange_strong(start, now, std::memory_order_relaxed)) {
+            return false;
+        }
+        passed_.store(0, std::memory_order_relaxed);
+        reportSuppressed(exclude);
+        return true;
+    }
+
+    void registerSite();
+
+    const LogLevel level_;
+    const char* const file_;
+    const int line_;
+    const std::uint32_t every_n_;
+    const std::uint32_t max_per_interval_;
+    const long long interval_ms_;
+    std::atomic<std::uint64_t> calls_{0};
+    std::atomic<std::uint32_t> passed_{0};
+    std::atomic<long long> interval_start_{0};
+    std::atomic<std::uint64_t> suppressed_{0};
+    std::atomic<bool> registered_{false};
+};
+
+// Logs one in every `every_n` calls from this site.
+#define LOG_EVERY_N(level, every_n, ...)                                                          \
+    do {                                                                                          \
+        static LogSite ocean_log_site_((level), __FILE__, __LINE__, (every_n), 0);               \
+        if (Logger::isEnabled(level) && ocean_log_site_.allow()) Logger::log((level), __VA_ARGS__); \
+    } while (0)
+
+// Logs at most `max_per_second` calls per second from this site.
+#define LOG_RATE_LIMITED(level, max_per_second, ...)                                              \
+    do {                                                                                          \
+        static LogSite ocean_log_site_((level), __FILE__, __LINE__, 1, (max_per_second));        \
+        if (Logger::isEnabled(level) && ocean_log_site_.allow()) Logger::log((level), __VA_ARGS__); \
+    } while (0)
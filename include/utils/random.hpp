@@ -1,34 +1,186 @@
 #pragma once
 #include <random>
-#include <chrono> 
-#include <vector> 
-#include <algorithm> 
+#include <cstdint>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <functional>
+#include <thread>
+
+// Unbiased integer in [0, range) for 1 <= range <= 2^32, drawn from a 64-bit
+// engine. Lemire's multiply-shift reduction: the rejection step (and its
+// modulo) only runs for the rare draws that fall in the biased sliver.
+template<typename Engine>
+inline std::uint64_t uniformBelow(Engine& engine, std::uint64_t range) {
+    std::uint64_t x = engine() >> 32;
+    std::uint64_t m = x * range;
+    std::uint32_t low = static_cast<std::uint32_t>(m);
+    if (low < range) {
+        const std::uint32_t threshold = static_cast<std::uint32_t>((0x100000000ull - range) % range);
+        while (low < threshold) {
+            x = engine() >> 32;
+            m = x * range;
+            low = static_cast<std::uint32_t>(m);
+        }
+    }
+    return m >> 32;
+}
+
+template<typename Engine>
+inline int uniformInt(Engine& engine, int min, int max) {
+    if (min > max) {
+        std::swap(min, max);
+    }
+    const std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(max) - min) + 1;
+    return static_cast<int>(min + static_cast<std::int64_t>(uniformBelow(engine, range)));
+}
+
+// Small counter-based generator for reproducible streams, e.g. one stream per
+// entity per tick in the intent update mode: seeding with mix(seed, tick,
+// cell) gives the same draws regardless of which thread plans the entity.
+class SplitMix64 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit SplitMix64(std::uint64_t seed) : state_(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    static std::uint64_t mix(std::uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    static std::uint64_t mix(std::uint64_t a, std::uint64_t b) {
+        return mix(mix(a) ^ b);
+    }
+
+    static std::uint64_t mix(std::uint64_t a, std::uint64_t b, std::uint64_t c) {
+        return mix(mix(mix(a) ^ b) ^ c);
+    }
+
+    result_type operator()() {
+        state_ += 0x9E3779B97F4A7C15ull;
+        std::uint64_t value = state_;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+    int nextInt(int min, int max) {
+        return uniformInt(*this, min, max);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+// xoshiro256** (Blackman & Vigna): 32 bytes of state, a handful of shifts and
+// rotations per draw. Seeded by expanding one 64-bit value with SplitMix64,
+// which never yields the all-zero state.
+class Xoshiro256 {
+public:
+    using result_type = std::uint64_t;
+
+    explicit Xoshiro256(std::uint64_t seed_value = 0) { seed(seed_value); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return ~result_type(0); }
+
+    void seed(std::uint64_t seed_value) {
+        SplitMix64 expander(seed_value);
+        for (std::uint64_t& word : state_) {
+            word = expander();
+        }
+    }
+
+    result_type operator()() {
+        const std::uint64_t result = rotl(state_[1] * 5, 7) * 9;
+        const std::uint64_t t = state_[1] << 17;
+        state_[2] ^= state_[0];
+        state_[3] ^= state_[1];
+        state_[1] ^= state_[2];
+        state_[0] ^= state_[3];
+        state_[2] ^= t;
+        state_[3] = rotl(state_[3], 45);
+        return result;
+    }
+
+private:
+    static std::uint64_t rotl(std::uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    std::uint64_t state_[4];
+};
 
 class Random {
 public:
-    static std::mt19937& getGenerator() {
-        static std::mt19937 generator(static_cast<unsigned int>(std::chrono::system_clock::now().time_since_epoch().count()));
-        return generator;
+    using Engine = Xoshiro256;
+
+    // One generator per thread so that parallel ticks never share state.
+    // Thread n (numbered by first use) draws from the stream mix(seed, n);
+    // seed() reseeds every thread's generator on its next draw.
+    static Engine& getGenerator() {
+        thread_local ThreadState state;
+        const std::uint64_t epoch = seed_epoch_.load(std::memory_order_acquire);
+        if (state.epoch != epoch) {
+            state.epoch = epoch;
+            state.engine.seed(SplitMix64::mix(base_seed_.load(std::memory_order_relaxed), state.stream));
+        }
+        return state.engine;
+    }
+
+    // Makes runs reproducible; without a call the seed comes from the clock.
+    static void seed(std::uint64_t value) {
+        base_seed_.store(value, std::memory_order_relaxed);
+        seed_epoch_.fetch_add(1, std::memory_order_release);
     }
 
     static int getInt(int min, int max) {
-        if (min > max) {
-            std::swap(min, max);
-        }
-        std::uniform_int_distribution<int> distribution(min, max);
-        return distribution(getGenerator());
+        return uniformInt(getGenerator(), min, max);
     }
 
     static double getDouble(double min, double max) {
         if (min > max) {
             std::swap(min, max);
         }
-        std::uniform_real_distribution<double> distribution(min, max);
-        return distribution(getGenerator());
+        const double unit = static_cast<double>(getGenerator()() >> 11) * 0x1.0p-53;
+        return min + (max - min) * unit;
     }
-    
-    template<typename T>
-    static void shuffle(std::vector<T>& vec) {
-        std::shuffle(vec.begin(), vec.end(), getGenerator());
+
+    // Uniformly chosen element of a non-empty container; cheaper than
+    // shuffling when only one element is needed.
+    template<typename Container>
+    static auto pick(Container& items) -> decltype(*std::begin(items)) {
+        const auto count = std::distance(std::begin(items), std::end(items));
+        return *(std::begin(items) + static_cast<std::ptrdiff_t>(uniformBelow(getGenerator(), static_cast<std::uint64_t>(count))));
     }
-};
\ No newline at end of file
+
+    template<typename Container>
+    static void shuffle(Container& items) {
+        Engine& engine = getGenerator();
+        const auto first = std::begin(items);
+        for (auto i = std::distance(first, std::end(items)) - 1; i > 0; --i) {
+            const auto j = static_cast<std::ptrdiff_t>(uniformBelow(engine, static_cast<std::uint64_t>(i) + 1));
+            std::iter_swap(first + i, first + j);
+        }
+    }
+
+private:
+    struct ThreadState {
+        Engine engine;
+        std::uint64_t epoch = 0;
+        std::uint64_t stream = next_stream_.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    inline static std::atomic<std::uint64_t> base_seed_{static_cast<std::uint64_t>(
+        std::chrono::system_clock::now().time_since_epoch().count())};
+    inline static std::atomic<std::uint64_t> seed_epoch_{1};
+    inline static std::atomic<std::uint64_t> next_stream_{0};
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity history that overwrites its oldest entry once full. A
+// capacity of 0 keeps nothing.
+template<typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity = 0) : slots_(capacity) {}
+
+    // Keeps the most recent entries that still fit.
+    void setCapacity(size_t capacity) {
+        std::vector<T> kept = toVector();
+        if (kept.size() > capacity) {
+            kept.erase(kept.begin(), kept.end() - static_cast<std::ptrdiff_t>(capacity));
+        }
+        slots_.assign(capacity, T{});
+        std::copy(kept.begin(), kept.end(), slots_.begin());
+        size_ = kept.size();
+        next_ = capacity > 0 ? size_ % capacity : 0;
+    }
+
+    size_t capacity() const { return slots_.size(); }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void push(const T& value) {
+        if (slots_.empty()) {
+            return;
+        }
+        slots_[next_] = value;
+        next_ = (next_ + 1) % slots_.size();
+        size_ = std::min(size_ + 1, slots_.size());
+    }
+
+    void clear() {
+        next_ = 0;
+        size_ = 0;
+    }
+
+    // Most recent entry; must not be called when empty.
+    const T& back() const {
+        return slots_[(next_ + slots_.size() - 1) % slots_.size()];
+    }
+
+    // Entries, oldest first.
+    std::vector<T> toVector() const {
+        std::vector<T> values;
+        values.reserve(size_);
+        const size_t first = slots_.empty() ? 0 : (next_ + slots_.size() - size_) % slots_.size();
+        for (size_t i = 0; i < size_; ++i) {
+            values.push_back(slots_[(first + i) % slots_.size()]);
+        }
+        return values;
+    }
+
+private:
+    std::vector<T> slots_;
+    size_t next_ = 0;
+    size_t size_ = 0;
+};
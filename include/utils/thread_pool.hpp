@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool for fork/join loops. run() hands out task indices to the
+// calling thread (worker 0) and the pool threads (workers 1..n-1) and returns
+// once every task has finished.
+class ThreadPool {
+public:
+    explicit ThreadPool(int thread_count) {
+        if (thread_count < 1) {
+            thread_count = 1;
+        }
+        for (int worker = 1; worker < thread_count; ++worker) {
+            threads_.emplace_back([this, worker] { workerLoop(worker); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int getThreadCount() const {
+        return static_cast<int>(threads_.size()) + 1;
+    }
+
+    // Calls task(index, worker) for every index in [0, count).
+    void run(int count, const std::function<void(int, int)>& task) {
+        if (count <= 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &task;
+            task_count_ = count;
+            next_task_.store(0);
+            busy_workers_ = static_cast<int>(threads_.size());
+            first_error_ = nullptr;
+            ++generation_;
+        }
+        wake_.notify_all();
+        drain(0);
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] { return busy_workers_ == 0; });
+            task_ = nullptr;
+            error = first_error_;
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const std::function<void(int, int)>* task_ = nullptr;
+    int task_count_ = 0;
+    std::atomic<int> next_task_{0};
+    int busy_workers_ = 0;
+    unsigned long long generation_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr first_error_;
+
+    void drain(int worker) {
+        for (int index = next_task_.fetch_add(1); index < task_count_; index = next_task_.fetch_add(1)) {
+            try {
+                (*task_)(index, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!first_error_) {
+                    first_error_ = std::current_exception();
+                }
+            }
+        }
+    }
+
+    void workerLoop(int worker) {
+        unsigned long long seen_generation = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+            lock.unlock();
+            drain(worker);
+            lock.lock();
+            if (--busy_workers_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include "entity.hpp"
+#include "utils/ring_buffer.hpp"
+
+// Tick instrumentation is compiled in only with OCEAN_ENABLE_PROFILER=1 (the
+// CMake option of the same name). Without it the hooks in Ocean::tick() are
+// discarded at compile time and Ocean's profiling calls do nothing.
+#ifndef OCEAN_ENABLE_PROFILER
+#define OCEAN_ENABLE_PROFILER 0
+#endif
+
+// Wall-clock phases of one tick, measured on the thread calling tick().
+//   FLOW_FIELDS  building the per-tick flow fields
+//   COLLECT      gathering and ordering the entities to update: the serial
+//                copy and shuffle, the tile bucketing of a parallel tick (the
+//                per-tile shuffles run inside UPDATE), or building and sorting
+//                the plans of an INTENT tick
+//   UPDATE       running entity updates
+//   SWEEP        removing the entities that died
+//   TOTAL        the whole tick
+enum class TickPhase : int {
+    FLOW_FIELDS,
+    COLLECT,
+    UPDATE,
+    SWEEP,
+    TOTAL
+};
+constexpr int TICK_PHASE_COUNT = 5;
+
+inline const char* tickPhaseToString(TickPhase phase) {
+    switch (phase) {
+        case TickPhase::FLOW_FIELDS: return "flow_fields";
+        case TickPhase::COLLECT:     return "collect";
+        case TickPhase::UPDATE:      return "update";
+        case TickPhase::SWEEP:       return "sweep";
+        case TickPhase::TOTAL:       return "total";
+        default:                     return "unknown";
+    }
+}
+
+// Species slots of TickProfile::species_ns.
+constexpr int PROFILED_SPECIES_COUNT = 3;
+
+inline int profiledSpeciesSlot(EntityType type) {
+    return static_cast<int>(type) - static_cast<int>(EntityType::ALGAE);
+}
+
+// One tick's measurements. species_ns is the time spent in the updates of
+// each species (ALGAE, HERBIVORE, PREDATOR), summed over worker threads, so
+// in a parallel tick it can exceed the UPDATE wall time.
+//
+// The counters count Ocean grid calls made during the tick, not outcomes
+// as the species see them, and one action can show up in several of them:
+//   updates  entity updates run
+//   moves    moveEntity calls that moved an entity to a different cell,
+//            including the move of a fish into the cell it just ate from
+//            (an eat followed by a move counts in both moves and eats)
+//   eats     removeEntity calls that took an entity other than the one
+//            being updated off the grid, whatever its type
+//   births   successful addEntity calls: offspring, algae spawns, and any
+//            entity put back after a removal (so a predator that removes
+//            and re-adds a non-herbivore counts one eat and one birth)
+//   deaths   dead entities removed by the end-of-tick sweep
+struct TickProfile {
+    unsigned long long tick = 0;
+    std::uint64_t phase_ns[TICK_PHASE_COUNT] = {};
+    std::uint64_t species_ns[PROFILED_SPECIES_COUNT] = {};
+    std::uint64_t updates = 0;
+    std::uint64_t moves = 0;
+    std::uint64_t eats = 0;
+    std::uint64_t births = 0;
+    std::uint64_t deaths = 0;
+};
+
+// Keeps the profiles of the last `window` ticks in a ring and summarizes
+// them as a histogram of durations in power-of-two microsecond buckets.
+class TickProfiler {
+public:
+    static constexpr bool COMPILED = OCEAN_ENABLE_PROFILER != 0;
+    static constexpr size_t DEFAULT_WINDOW = 1024;
+    static constexpr int HISTOGRAM_BUCKETS = 24; // <1us, [1,2)us, ... , >=2^22us
+
+    using Clock = std::chrono::steady_clock;
+
+    static std::uint64_t nanosBetween(Clock::time_point start, Clock::time_point end) {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    explicit TickProfiler(size_t window = DEFAULT_WINDOW);
+
+    // Resizing keeps the most recent profiles that still fit.
+    void setWindow(size_t ticks);
+    size_t getWindow() const { return ring_.capacity(); }
+
+    void record(const TickProfile& profile);
+    void clear();
+
+    size_t size() const { return ring_.size(); }
+    // Most recent profile; a default TickProfile when nothing was recorded.
+    TickProfile last() const;
+    // Recorded profiles, oldest first.
+    std::vector<TickProfile> history() const;
+
+    // Writes mean/p50/p99/max and the bucket counts of every phase and
+    // species over the window, followed by the mean counters per tick.
+    void dump(std::ostream& out) const;
+
+    static int bucketOf(std::uint64_t nanos);
+
+private:
+    RingBuffer<TickProfile> ring_;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-writer, single-reader hand-off of the latest value. The
+// writer fills writeBuffer() and publish()es it; the reader calls update()
+// and reads readBuffer(), which stays valid and untouched until its next
+// update(). Neither side ever waits: values published faster than they are
+// read are dropped, and the reader always moves to the newest one.
+//
+// Three slots rotate between the writer (back), the reader (front) and the
+// last published value (middle); only the middle index is shared, with a
+// flag telling the reader it has not been picked up yet.
+template<typename T>
+class TripleBuffer {
+public:
+    T& writeBuffer() { return slots_[back_]; }
+
+    void publish() {
+        const std::uint8_t previous = middle_.exchange(static_cast<std::uint8_t>(back_ | FRESH), std::memory_order_acq_rel);
+        back_ = static_cast<std::uint8_t>(previous & INDEX_MASK);
+    }
+
+    // Returns true and switches readBuffer() to the newest value if one was
+    // published since the last successful update().
+    bool update() {
+        if ((middle_.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        const std::uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = static_cast<std::uint8_t>(previous & INDEX_MASK);
+        return true;
+    }
+
+    const T& readBuffer() const { return slots_[front_]; }
+
+private:
+    static constexpr std::uint8_t INDEX_MASK = 0x3;
+    static constexpr std::uint8_t FRESH = 0x4;
+
+    T slots_[3];
+    alignas(64) std::uint8_t back_ = 0;   // writer only
+    alignas(64) std::uint8_t front_ = 1;  // reader only
+    alignas(64) std::atomic<std::uint8_t> middle_{2};
+};
@@ -2,6 +2,7 @@
 #include "ocean.hpp"
 #include "utils/random.hpp"
 #include "utils/logger.hpp" 
+#include "utils/event_log.hpp"
 #include <vector>
 #include <utility> 
 
@@ -10,19 +11,43 @@ Algae::Algae() {}
 void Algae::update(Ocean& ocean, int r, int c) {
     constexpr int REPRODUCTION_CHANCE_PERCENT = 3; 
     if (Random::getInt(1, 100) <= REPRODUCTION_CHANCE_PERCENT) {
-        std::vector<std::pair<int, int>> emptyNeighbors = ocean.getEmptyAdjacentCells(r, c);
+        NeighborList emptyNeighbors;
+        ocean.getEmptyAdjacentCells(r, c, emptyNeighbors);
         
         if (!emptyNeighbors.empty()) {
-            Random::shuffle(emptyNeighbors);
-            std::pair<int, int> targetCell = emptyNeighbors[0];
+            std::pair<int, int> targetCell = Random::pick(emptyNeighbors);
             
-            if (ocean.addEntity(std::make_unique<Algae>(), targetCell.first, targetCell.second)) {
+            if (ocean.addEntity(ocean.createEntity<Algae>(), targetCell.first, targetCell.second)) {
+                EventLog::emit(EventType::SPAWN, EntityType::ALGAE, r, c, targetCell.first, targetCell.second, 0);
                 Logger::debug("Algae at (", r, ",", c, ") reproduced to (", targetCell.first, ",", targetCell.second, ")");
             }
         }
     }
 }
 
+Intent Algae::planUpdate(const Ocean& ocean, int r, int c, SplitMix64& rng) const {
+    constexpr int REPRODUCTION_CHANCE_PERCENT = 3; 
+    Intent intent;
+    if (rng.nextInt(1, 100) <= REPRODUCTION_CHANCE_PERCENT) {
+        NeighborList emptyNeighbors;
+        ocean.getEmptyAdjacentCells(r, c, emptyNeighbors);
+        if (!emptyNeighbors.empty()) {
+            intent.spawn = emptyNeighbors[rng.nextInt(0, emptyNeighbors.size() - 1)];
+        }
+    }
+    return intent;
+}
+
+void Algae::applyUpdate(Ocean& ocean, int r, int c, const Intent& intent) {
+    if (intent.spawn.first < 0) {
+        return;
+    }
+    if (ocean.addEntity(ocean.createEntity<Algae>(), intent.spawn.first, intent.spawn.second)) {
+        EventLog::emit(EventType::SPAWN, EntityType::ALGAE, r, c, intent.spawn.first, intent.spawn.second, 0);
+        Logger::debug("Algae at (", r, ",", c, ") reproduced to (", intent.spawn.first, ",", intent.spawn.second, ")");
+    }
+}
+
 char Algae::getSymbol() const {
     return 'A';
 }
@@ -0,0 +1,127 @@
+#include "entity_pool.hpp"
+#include "algae.hpp"
+#include "herbivore.hpp"
+#include "predator.hpp"
+#include "utils/logger.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace {
+    size_t roundToSlot(size_t size) {
+        const size_t align = alignof(std::max_align_t);
+        return (size + align - 1) / align * align;
+    }
+}
+
+void EntityDeleter::operator()(Entity* entity) const {
+    if (!entity) {
+        return;
+    }
+    if (pool_) {
+        pool_->destroy(entity);
+    } else {
+        delete entity;
+    }
+}
+
+EntityPool::Slab::Slab(size_t slot_size) : slot_size_(roundToSlot(slot_size)) {}
+
+void EntityPool::Slab::grow() {
+    if (slot_size_ == 0) {
+        throw std::logic_error("EntityPool::Slab::grow: slab has no slot size (SAND is never pooled).");
+    }
+    chunks_.push_back(std::make_unique<unsigned char[]>(slot_size_ * SLOTS_PER_CHUNK));
+    unsigned char* base = chunks_.back().get();
+    free_list_.reserve(free_list_.size() + SLOTS_PER_CHUNK);
+    for (size_t i = SLOTS_PER_CHUNK; i-- > 0;) {
+        free_list_.push_back(base + i * slot_size_);
+    }
+}
+
+void* EntityPool::Slab::allocate() {
+    if (free_list_.empty()) {
+        grow();
+    }
+    void* slot = free_list_.back();
+    free_list_.pop_back();
+    ++live_;
+    if (live_ > high_water_) {
+        high_water_ = live_;
+    }
+    return slot;
+}
+
+void EntityPool::Slab::release(void* slot) {
+    free_list_.push_back(slot);
+    --live_;
+}
+
+void EntityPool::Slab::reserve(size_t slots) {
+    while (live_ + free_list_.size() < slots) {
+        grow();
+    }
+}
+
+PoolStats EntityPool::Slab::getStats() const {
+    PoolStats stats;
+    stats.live = live_;
+    stats.free = free_list_.size();
+    stats.high_water = high_water_;
+    stats.capacity = chunks_.size() * SLOTS_PER_CHUNK;
+    return stats;
+}
+
+EntityPool::EntityPool()
+    : slabs_{Slab(0), Slab(sizeof(Algae)), Slab(sizeof(HerbivoreFish)), Slab(sizeof(PredatorFish))} {}
+
+EntityPool::Slab& EntityPool::slabFor(EntityType type) {
+    const int index = static_cast<int>(type);
+    if (index <= 0 || index >= SLAB_COUNT) {
+        std::string err_msg = "EntityPool: no slab for entity type " + std::to_string(index) + ".";
+        Logger::error(err_msg);
+        throw std::invalid_argument(err_msg);
+    }
+    return slabs_[index];
+}
+
+const EntityPool::Slab& EntityPool::slabFor(EntityType type) const {
+    return const_cast<EntityPool*>(this)->slabFor(type);
+}
+
+void* EntityPool::allocateSlot(EntityType type) {
+    Slab& slab = slabFor(type);
+    if (concurrent_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slab.allocate();
+    }
+    return slab.allocate();
+}
+
+void EntityPool::releaseSlot(EntityType type, void* slot) {
+    Slab& slab = slabFor(type);
+    if (concurrent_) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slab.release(slot);
+        return;
+    }
+    slab.release(slot);
+}
+
+void EntityPool::destroy(Entity* entity) {
+    const EntityType type = entity->getType();
+    entity->~Entity();
+    releaseSlot(type, entity);
+}
+
+void EntityPool::setConcurrent(bool concurrent) {
+    concurrent_ = concurrent;
+}
+
+void EntityPool::reserve(EntityType type, size_t slots) {
+    slabFor(type).reserve(slots);
+}
+
+PoolStats EntityPool::getStats(EntityType type) const {
+    return slabFor(type).getStats();
+}
@@ -0,0 +1,222 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "ocean.hpp"
+#include "algae.hpp"
+#include "herbivore.hpp"
+#include "predator.hpp"
+#include "utils/event_log.hpp"
+#include "utils/logger.hpp"
+#include "utils/random.hpp"
+
+// Runs the simulation without a window, for large grids, batch experiments
+// and profiling.
+namespace {
+
+struct HeadlessOptions {
+    int rows = 50;
+    int cols = 50;
+    // Fraction of cells seeded with each species; same as OceanGame.
+    double algae_density = 1.0 / 15;
+    double herbivore_density = 1.0 / 100;
+    double predator_density = 1.0 / 300;
+    std::uint64_t seed = 0;
+    bool has_seed = false;
+    int ticks = 1000;
+    int report_every = 100;
+    int threads = 1;
+    UpdateMode update_mode = UpdateMode::IN_PLACE;
+    FlowFieldMode flow_field_mode = FlowFieldMode::AUTO;
+    bool log_to_file = false;
+    std::string events_path;
+    bool profile = false;
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --size N                 square grid of N x N cells\n"
+              << "  --rows N, --cols N       grid size (default 50 x 50)\n"
+              << "  --algae D                initial algae density, fraction of cells (default 0.0667)\n"
+              << "  --herbivores D           initial herbivore density (default 0.01)\n"
+              << "  --predators D            initial predator density (default 0.0033)\n"
+              << "  --seed S                 seed for placement and updates (default: from the clock)\n"
+              << "  --ticks N                number of ticks to run (default 1000)\n"
+              << "  --report-every N         print populations every N ticks, 0 for final only (default 100)\n"
+              << "  --threads N              worker threads, 0 for all cores (default 1)\n"
+              << "  --mode in-place|intent   update mode (default in-place)\n"
+              << "  --flow-field off|auto|always  flow fields for hungry fish (default auto)\n"
+              << "  --log                    write log lines to " LOG_TO_FILE " (info lines need OCEAN_LOG_COMPILE_MIN_LEVEL <= 1;\n"
+              << "                           Release builds default to 2 and only log warnings)\n"
+              << "  --events PATH            record the binary event stream to PATH\n"
+              << "  --profile                print per-phase tick timings at the end (needs OCEAN_ENABLE_PROFILER)\n";
+}
+
+HeadlessOptions parseOptions(int argc, char** argv) {
+    HeadlessOptions options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--size") {
+            options.rows = options.cols = std::stoi(value());
+        } else if (arg == "--rows") {
+            options.rows = std::stoi(value());
+        } else if (arg == "--cols") {
+            options.cols = std::stoi(value());
+        } else if (arg == "--algae") {
+            options.algae_density = std::stod(value());
+        } else if (arg == "--herbivores") {
+            options.herbivore_density = std::stod(value());
+        } else if (arg == "--predators") {
+            options.predator_density = std::stod(value());
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(value());
+            options.has_seed = true;
+        } else if (arg == "--ticks") {
+            options.ticks = std::stoi(value());
+        } else if (arg == "--report-every") {
+            options.report_every = std::stoi(value());
+        } else if (arg == "--threads") {
+            options.threads = std::stoi(value());
+        } else if (arg == "--mode") {
+            const std::string mode = value();
+            if (mode == "in-place") {
+                options.update_mode = UpdateMode::IN_PLACE;
+            } else if (mode == "intent") {
+                options.update_mode = UpdateMode::INTENT;
+            } else {
+                throw std::invalid_argument("unknown mode " + mode);
+            }
+        } else if (arg == "--flow-field") {
+            const std::string mode = value();
+            if (mode == "off") {
+                options.flow_field_mode = FlowFieldMode::OFF;
+            } else if (mode == "auto") {
+                options.flow_field_mode = FlowFieldMode::AUTO;
+            } else if (mode == "always") {
+                options.flow_field_mode = FlowFieldMode::ALWAYS;
+            } else {
+                throw std::invalid_argument("unknown flow field mode " + mode);
+            }
+        } else if (arg == "--log") {
+            options.log_to_file = true;
+        } else if (arg == "--events") {
+            options.events_path = value();
+        } else if (arg == "--profile") {
+            options.profile = true;
+        } else {
+            throw std::invalid_argument("unknown option " + arg);
+        }
+    }
+    if (options.rows <= 0 || options.cols <= 0 || options.ticks < 0) {
+        throw std::invalid_argument("grid size must be positive and ticks non-negative");
+    }
+    return options;
+}
+
+template<typename T>
+int seedSpecies(Ocean& ocean, double density) {
+    const long long attempts = static_cast<long long>(density * ocean.getRows() * ocean.getCols());
+    int added = 0;
+    for (long long i = 0; i < attempts; ++i) {
+        const int r = Random::getInt(0, ocean.getRows() - 1);
+        const int c = Random::getInt(0, ocean.getCols() - 1);
+        if (ocean.addEntity(ocean.createEntity<T>(), r, c)) {
+            ++added;
+        }
+    }
+    return added;
+}
+
+void printPopulation(unsigned long long tick, const PopulationStats& stats) {
+    std::printf("%10llu %10d %10d %10d\n", tick, stats.algae, stats.herbivores, stats.predators);
+}
+
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0 || std::strcmp(argv[i], "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        }
+    }
+
+    HeadlessOptions options;
+    try {
+        options = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    if (options.log_to_file) {
+        if constexpr (COMPILE_MIN_LOG_LEVEL > LogLevel::INFO) {
+            std::cerr << "Warning: info lines are compiled out of this build (OCEAN_LOG_COMPILE_MIN_LEVEL="
+                      << OCEAN_LOG_COMPILE_MIN_LEVEL << "), so " LOG_TO_FILE " only gets warnings and errors\n";
+        }
+        Logger::init();
+    }
+    if (!options.events_path.empty() && !EventLog::open(options.events_path)) {
+        return 1;
+    }
+
+    const std::uint64_t seed = options.has_seed ? options.seed : Random::getGenerator()();
+    Random::seed(seed);
+
+    int exit_code = 0;
+    try {
+        Ocean ocean(options.rows, options.cols);
+        ocean.setIntentSeed(seed);
+        ocean.setUpdateMode(options.update_mode);
+        ocean.setFlowFieldMode(options.flow_field_mode);
+        ocean.setThreadCount(options.threads);
+        ocean.setProfilingEnabled(options.profile);
+        seedSpecies<Algae>(ocean, options.algae_density);
+        seedSpecies<HerbivoreFish>(ocean, options.herbivore_density);
+        seedSpecies<PredatorFish>(ocean, options.predator_density);
+
+        std::printf("grid %dx%d, seed %llu, %d threads, %s updates\n", options.rows, options.cols,
+                    static_cast<unsigned long long>(seed), ocean.getThreadCount(),
+                    options.update_mode == UpdateMode::INTENT ? "intent" : "in-place");
+        std::printf("%10s %10s %10s %10s\n", "tick", "algae", "herbivores", "predators");
+        printPopulation(ocean.getTickCount(), ocean.getPopulationStats());
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < options.ticks; ++t) {
+            ocean.tick();
+            if (options.report_every > 0 && ocean.getTickCount() % options.report_every == 0) {
+                printPopulation(ocean.getTickCount(), ocean.getPopulationStats());
+            }
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (options.report_every <= 0 || ocean.getTickCount() % options.report_every != 0) {
+            printPopulation(ocean.getTickCount(), ocean.getPopulationStats());
+        }
+        std::printf("%d ticks in %.3f s: %.1f ticks/sec\n", options.ticks, seconds,
+                    seconds > 0.0 ? options.ticks / seconds : 0.0);
+        if (ocean.isProfilingEnabled()) {
+            ocean.dumpTickProfile(std::cout);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        exit_code = 1;
+    }
+
+    EventLog::close();
+    if (options.log_to_file) {
+        Logger::shutdown();
+    }
+    return exit_code;
+}
@@ -2,9 +2,15 @@
 #include "ocean.hpp"
 #include "algae.hpp" 
 #include "utils/logger.hpp"
+#include "utils/event_log.hpp"
 #include <vector>
 #include <utility> 
 
+namespace {
+// Eating happens thousands of times per tick on a large grid.
+constexpr std::uint32_t EAT_LOG_LINES_PER_SECOND = 100;
+}
+
 HerbivoreFish::HerbivoreFish(int initial_energy) 
     : energy_(initial_energy), age_(0) {
     if (energy_ > Config::HERBIVORE_MAX_ENERGY) { 
@@ -13,17 +19,37 @@ HerbivoreFish::HerbivoreFish(int initial_energy)
 }
 
 bool HerbivoreFish::isDead() const {
-    return energy_ <= 0 || age_ >= Config::HERBIVORE_MAX_AGE;
+    return isDying(energy_, age_);
+}
+
+bool HerbivoreFish::isDying(int energy, int age) {
+    return energy <= 0 || age >= Config::HERBIVORE_MAX_AGE;
+}
+
+bool HerbivoreFish::isStarving(int energy) {
+    return energy < Config::HERBIVORE_CRITICAL_ENERGY_THRESHOLD / 2;
+}
+
+bool HerbivoreFish::isSeekingFood(int energy) {
+    return energy < Config::HERBIVORE_CRITICAL_ENERGY_THRESHOLD * 1.5;
+}
+
+int HerbivoreFish::getEnergy() const {
+    return energy_;
+}
+
+int HerbivoreFish::getAge() const {
+    return age_;
 }
 
 bool HerbivoreFish::tryToEat(Ocean& ocean, int current_r, int current_c) {
-    std::vector<std::pair<int, int>> algaeNeighbors = ocean.getAdjacentCellsOfType(current_r, current_c, EntityType::ALGAE);
+    NeighborList algaeNeighbors;
+    ocean.getAdjacentCellsOfType(current_r, current_c, EntityType::ALGAE, algaeNeighbors);
 
     if (!algaeNeighbors.empty()) {
-        Random::shuffle(algaeNeighbors); 
-        std::pair<int, int> algaePos = algaeNeighbors[0];
+        std::pair<int, int> algaePos = Random::pick(algaeNeighbors);
 
-        std::unique_ptr<Entity> eatenAlgae = ocean.removeEntity(algaePos.first, algaePos.second);
+        EntityPtr eatenAlgae = ocean.removeEntity(algaePos.first, algaePos.second);
         if (eatenAlgae) { 
             energy_ += Config::HERBIVORE_ENERGY_FROM_ALGAE;
             if (energy_ > Config::HERBIVORE_MAX_ENERGY) {
@@ -32,7 +58,8 @@ bool HerbivoreFish::tryToEat(Ocean& ocean, int current_r, int current_c) {
 
             Logger::debug("H @(",current_r,",",current_c,") moving to eat at (",algaePos.first,",",algaePos.second,")");
             ocean.moveEntity(current_r, current_c, algaePos.first, algaePos.second);
-            Logger::info("H at (", algaePos.first, ",", algaePos.second, ") ate Algae. E:", energy_);
+            EventLog::emit(EventType::EAT, EntityType::HERBIVORE, current_r, current_c, algaePos.first, algaePos.second, energy_);
+            LOG_RATE_LIMITED(LogLevel::INFO, EAT_LOG_LINES_PER_SECOND, "H at (", algaePos.first, ",", algaePos.second, ") ate Algae. E:", energy_);
             return true;
         }
     }
@@ -43,15 +70,16 @@ bool HerbivoreFish::tryToReproduce(Ocean& ocean, int current_r, int current_c) {
     if (energy_ >= Config::HERBIVORE_REPRODUCTION_ENERGY_THRESHOLD &&
         Random::getInt(1, 100) <= Config::HERBIVORE_REPRODUCTION_CHANCE_PERCENT) {
         
-        std::vector<std::pair<int, int>> emptyNeighbors = ocean.getEmptyAdjacentCells(current_r, current_c);
+        NeighborList emptyNeighbors;
+        ocean.getEmptyAdjacentCells(current_r, current_c, emptyNeighbors);
         if (!emptyNeighbors.empty()) {
-            Random::shuffle(emptyNeighbors);
-            std::pair<int, int> offspringPos = emptyNeighbors[0];
+            std::pair<int, int> offspringPos = Random::pick(emptyNeighbors);
 
-            auto offspring = std::make_unique<HerbivoreFish>(Config::HERBIVORE_OFFSPRING_INITIAL_ENERGY);
+            auto offspring = ocean.createEntity<HerbivoreFish>(Config::HERBIVORE_OFFSPRING_INITIAL_ENERGY);
             
             if (ocean.addEntity(std::move(offspring), offspringPos.first, offspringPos.second)) {
                 energy_ -= Config::HERBIVORE_REPRODUCTION_COST; 
+                EventLog::emit(EventType::BIRTH, EntityType::HERBIVORE, current_r, current_c, offspringPos.first, offspringPos.second, energy_);
                 Logger::info("H at (", current_r, ",", current_c, ") reproduced to (", 
                            offspringPos.first, ",", offspringPos.second, "). Parent E:", energy_);
                 return true;
@@ -62,7 +90,7 @@ bool HerbivoreFish::tryToReproduce(Ocean& ocean, int current_r, int current_c) {
 }
 
 void HerbivoreFish::intelligentMove(Ocean& ocean, int current_r, int current_c) {
-    if (energy_ < Config::HERBIVORE_CRITICAL_ENERGY_THRESHOLD * 1.5) {
+    if (isSeekingFood(energy_)) {
         std::pair<int, int> direction = ocean.getDirectionToNearestTarget(current_r, current_c, EntityType::ALGAE, Config::HERBIVORE_SIGHT_RADIUS);
 
         if (direction.first != 0 || direction.second != 0) { 
@@ -72,7 +100,9 @@ void HerbivoreFish::intelligentMove(Ocean& ocean, int current_r, int current_c)
                 Entity* entity_at_target_step = ocean.getEntity(next_r, next_c);
                 if (!entity_at_target_step) {
                     Logger::debug("H @(", current_r, ",", current_c, ") moving towards food to (", next_r, ",", next_c, ")");
-                    ocean.moveEntity(current_r, current_c, next_r, next_c);
+                    if (ocean.moveEntity(current_r, current_c, next_r, next_c)) {
+                        EventLog::emit(EventType::MOVE, EntityType::HERBIVORE, current_r, current_c, next_r, next_c, energy_);
+                    }
                     return;
                 } else if (entity_at_target_step->getType() == EntityType::ALGAE) {
                      Logger::debug("H @(", current_r, ",", current_c, ") sees food at (", next_r, ",", next_c, ") but cell not empty for step. Will try random.");
@@ -82,12 +112,14 @@ void HerbivoreFish::intelligentMove(Ocean& ocean, int current_r, int current_c)
     }
 
     Logger::debug("H @(", current_r, ",", current_c, ") moving randomly.");
-    std::vector<std::pair<int, int>> emptyNeighbors = ocean.getEmptyAdjacentCells(current_r, current_c);
+    NeighborList emptyNeighbors;
+    ocean.getEmptyAdjacentCells(current_r, current_c, emptyNeighbors);
     if (!emptyNeighbors.empty()) {
-        Random::shuffle(emptyNeighbors); 
-        std::pair<int, int> targetCell = emptyNeighbors[0];
+        std::pair<int, int> targetCell = Random::pick(emptyNeighbors);
         Logger::debug("H @(", current_r, ",", current_c, ") random move to (", targetCell.first, ",", targetCell.second, ")");
-        ocean.moveEntity(current_r, current_c, targetCell.first, targetCell.second);
+        if (ocean.moveEntity(current_r, current_c, targetCell.first, targetCell.second)) {
+            EventLog::emit(EventType::MOVE, EntityType::HERBIVORE, current_r, current_c, targetCell.first, targetCell.second, energy_);
+        }
     } else {
         Logger::debug("H @(", current_r, ",", current_c, ") has nowhere to move (randomly).");
     }
@@ -126,10 +158,103 @@ void HerbivoreFish::update(Ocean& ocean, int r, int c) {
     Logger::debug("H @(", r, ",", c, ") finished intelligentMove. Update finished.");
 }
 
+std::pair<int, int> HerbivoreFish::planMove(const Ocean& ocean, int current_r, int current_c, int energy,
+                                            std::pair<int, int> reserved, SplitMix64& rng) const {
+    if (isSeekingFood(energy)) {
+        std::pair<int, int> direction = ocean.getDirectionToNearestTarget(current_r, current_c, EntityType::ALGAE, Config::HERBIVORE_SIGHT_RADIUS);
+        if (direction.first != 0 || direction.second != 0) {
+            std::pair<int, int> next = {current_r + direction.first, current_c + direction.second};
+            if (next != reserved && ocean.isValidCoordinate(next.first, next.second) && !ocean.getEntity(next.first, next.second)) {
+                return next;
+            }
+        }
+    }
+
+    NeighborList emptyNeighbors;
+    ocean.getEmptyAdjacentCells(current_r, current_c, emptyNeighbors);
+    NeighborList candidates;
+    for (const auto& cell : emptyNeighbors) {
+        if (cell != reserved) {
+            candidates.push_back(cell);
+        }
+    }
+    if (candidates.empty()) {
+        return {-1, -1};
+    }
+    return candidates[rng.nextInt(0, candidates.size() - 1)];
+}
+
+// Mirrors update(): starve/age, eat adjacent algae, maybe reproduce, then move.
+Intent HerbivoreFish::planUpdate(const Ocean& ocean, int r, int c, SplitMix64& rng) const {
+    Intent intent;
+    int energy = energy_ - Config::HERBIVORE_ENERGY_PER_TICK;
+    if (energy <= 0 || age_ + 1 >= Config::HERBIVORE_MAX_AGE) {
+        return intent;
+    }
+
+    NeighborList algaeNeighbors;
+    ocean.getAdjacentCellsOfType(r, c, EntityType::ALGAE, algaeNeighbors);
+    if (!algaeNeighbors.empty()) {
+        intent.eat = algaeNeighbors[rng.nextInt(0, algaeNeighbors.size() - 1)];
+        return intent;
+    }
+
+    if (energy > Config::HERBIVORE_CRITICAL_ENERGY_THRESHOLD * 1.1 &&
+        energy >= Config::HERBIVORE_REPRODUCTION_ENERGY_THRESHOLD &&
+        rng.nextInt(1, 100) <= Config::HERBIVORE_REPRODUCTION_CHANCE_PERCENT) {
+        NeighborList emptyNeighbors;
+        ocean.getEmptyAdjacentCells(r, c, emptyNeighbors);
+        if (!emptyNeighbors.empty()) {
+            intent.spawn = emptyNeighbors[rng.nextInt(0, emptyNeighbors.size() - 1)];
+            energy -= Config::HERBIVORE_REPRODUCTION_COST;
+        }
+    }
+
+    intent.move = planMove(ocean, r, c, energy, intent.spawn, rng);
+    return intent;
+}
+
+void HerbivoreFish::applyUpdate(Ocean& ocean, int r, int c, const Intent& intent) {
+    age_++;
+    energy_ -= Config::HERBIVORE_ENERGY_PER_TICK;
+    if (isDead()) {
+        return;
+    }
+
+    if (intent.eat.first >= 0) {
+        Entity* target = ocean.getEntity(intent.eat.first, intent.eat.second);
+        if (target && target->getType() == EntityType::ALGAE) {
+            ocean.removeEntity(intent.eat.first, intent.eat.second);
+            energy_ += Config::HERBIVORE_ENERGY_FROM_ALGAE;
+            if (energy_ > Config::HERBIVORE_MAX_ENERGY) {
+                energy_ = Config::HERBIVORE_MAX_ENERGY;
+            }
+            ocean.moveEntity(r, c, intent.eat.first, intent.eat.second);
+            EventLog::emit(EventType::EAT, EntityType::HERBIVORE, r, c, intent.eat.first, intent.eat.second, energy_);
+            LOG_RATE_LIMITED(LogLevel::INFO, EAT_LOG_LINES_PER_SECOND, "H at (", intent.eat.first, ",", intent.eat.second, ") ate Algae. E:", energy_);
+        }
+        return;
+    }
+
+    if (intent.spawn.first >= 0 &&
+        ocean.addEntity(ocean.createEntity<HerbivoreFish>(Config::HERBIVORE_OFFSPRING_INITIAL_ENERGY), intent.spawn.first, intent.spawn.second)) {
+        energy_ -= Config::HERBIVORE_REPRODUCTION_COST;
+        EventLog::emit(EventType::BIRTH, EntityType::HERBIVORE, r, c, intent.spawn.first, intent.spawn.second, energy_);
+        Logger::info("H at (", r, ",", c, ") reproduced to (", 
+                   intent.spawn.first, ",", intent.spawn.second, "). Parent E:", energy_);
+        if (isDead()) {
+            return;
+        }
+    }
+
+    if (intent.move.first >= 0 && ocean.moveEntity(r, c, intent.move.first, intent.move.second)) {
+        EventLog::emit(EventType::MOVE, EntityType::HERBIVORE, r, c, intent.move.first, intent.move.second, energy_);
+    }
+}
 
 char HerbivoreFish::getSymbol() const {
     if (isDead()) return 'x';
-    if (energy_ < Config::HERBIVORE_CRITICAL_ENERGY_THRESHOLD / 2) return 'h'; 
+    if (isStarving(energy_)) return 'h';
     return 'H';
 }
 
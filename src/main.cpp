@@ -2,12 +2,16 @@
 #include "olc/olcPixelGameEngine.h"
 
 #include <string>
+#include <atomic>
 #include <memory>
 #include <vector>
 #include <chrono>
 #include <thread>
 #include <stdexcept>
 #include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 
 #include "ocean.hpp"
 #include "algae.hpp"
@@ -16,8 +20,17 @@
 #include "utils/random.hpp"
 #include "utils/logger.hpp"
 #include "utils/resource_wrapper.hpp"
+#include "utils/triple_buffer.hpp"
 
 const int SPRITE_SIZE = 16; 
+// The window shows at most this many cells a side at sprite size; larger
+// oceans are panned and zoomed out.
+const int MAX_VIEW_CELLS = 64;
+
+// What the simulation thread publishes after each tick.
+struct OceanSnapshot {
+    std::vector<std::uint8_t> states; // Ocean::getRenderStates()
+};
 
 class OceanGame : public olc::PixelGameEngine {
 public:
@@ -30,9 +43,18 @@ private:
     Ocean* pge_ocean_; 
     int ocean_rows_;
     int ocean_cols_;
-    float time_accumulator_ = 0.0f;
     const float TICK_INTERVAL = 0.5f; 
 
+    // From the end of OnUserCreate until OnUserDestroy the ocean belongs to
+    // the simulation thread, which ticks it every TICK_INTERVAL (or back to
+    // back once unthrottled) and publishes a snapshot after each tick. The
+    // render thread only reads the newest published snapshot, so neither
+    // side ever waits for the other.
+    TripleBuffer<OceanSnapshot> snapshots_;
+    std::thread sim_thread_;
+    std::atomic<bool> sim_running_{false};
+    std::atomic<bool> sim_unthrottled_{false};
+
     std::unique_ptr<olc::Sprite> sprSand;
     std::unique_ptr<olc::Sprite> sprAlgae;
     std::unique_ptr<olc::Sprite> sprHerbivore;
@@ -40,6 +62,294 @@ private:
     std::unique_ptr<olc::Sprite> sprHerbivoreHungry;
     std::unique_ptr<olc::Sprite> sprPredatorHungry;
 
+    // Sprite view, layers drawn bottom to top: the sand floor, painted once
+    // when the game starts (the view moves in whole cells, so the tiling
+    // never changes); the entities, transparent where a cell is empty, which
+    // keep their pixels between frames so that a new snapshot repaints only
+    // the visible cells whose state differs from drawn_states_, and the layer
+    // is re-uploaded only when a snapshot arrived; and layer 0, left
+    // transparent on top. Diffing against what is on screen, rather than
+    // replaying Ocean's dirty lists, stays correct when ticks outrun frames
+    // and intermediate snapshots are never seen.
+    //
+    // Overview, below ZOOM_SPRITES: both layers are hidden and layer 0 is
+    // written directly, 2^zoom pixels per cell, or at negative levels one
+    // pixel per 2^-zoom square of cells showing their average color. It is
+    // rewritten only when the view or the grid changed, at a cost
+    // proportional to the visible area.
+    static constexpr int ZOOM_SPRITES = 4; // 1 << 4 == SPRITE_SIZE
+    static constexpr int ZOOM_MIN = -10;
+    uint8_t entity_layer_ = 0;
+    uint8_t sand_layer_ = 0;
+    int zoom_ = ZOOM_SPRITES;
+    int min_zoom_ = 0;
+    int view_r_ = 0;
+    int view_c_ = 0;
+    float pan_r_ = 0.0f;
+    float pan_c_ = 0.0f;
+    bool full_repaint_ = true;
+    std::vector<std::uint8_t> drawn_states_;
+    olc::Pixel state_colors_[RENDER_STATE_COUNT];
+    std::vector<std::uint32_t> block_sums_;
+
+    // Sprite per render state byte, nullptr for empty cells. Dying fish keep
+    // their normal sprite until the sweep removes them.
+    olc::Sprite* state_sprites_[RENDER_STATE_COUNT] = {};
+
+    void buildStateSprites() {
+        for (int state = 0; state < RENDER_STATE_COUNT; ++state) {
+            const bool hungry = (state & RENDER_HUNGRY) != 0;
+            switch (renderStateType(static_cast<std::uint8_t>(state))) {
+                case EntityType::ALGAE:
+                    state_sprites_[state] = sprAlgae.get();
+                    break;
+                case EntityType::HERBIVORE:
+                    state_sprites_[state] = hungry ? sprHerbivoreHungry.get() : sprHerbivore.get();
+                    break;
+                case EntityType::PREDATOR:
+                    state_sprites_[state] = hungry ? sprPredatorHungry.get() : sprPredator.get();
+                    break;
+                default:
+                    state_sprites_[state] = nullptr;
+                    break;
+            }
+        }
+    }
+
+    // Overview color of each state: the average of the sprite's visible
+    // pixels, or of the sand for an empty cell.
+    static olc::Pixel averageColor(const olc::Sprite* sprite) {
+        std::uint64_t sum[3] = {0, 0, 0};
+        std::uint64_t weight = 0;
+        for (int32_t y = 0; y < sprite->height; ++y) {
+            for (int32_t x = 0; x < sprite->width; ++x) {
+                const olc::Pixel p = sprite->GetPixel(x, y);
+                sum[0] += static_cast<std::uint64_t>(p.r) * p.a;
+                sum[1] += static_cast<std::uint64_t>(p.g) * p.a;
+                sum[2] += static_cast<std::uint64_t>(p.b) * p.a;
+                weight += p.a;
+            }
+        }
+        if (weight == 0) {
+            return olc::BLACK;
+        }
+        return olc::Pixel(static_cast<uint8_t>(sum[0] / weight), static_cast<uint8_t>(sum[1] / weight),
+                          static_cast<uint8_t>(sum[2] / weight));
+    }
+
+    void buildStateColors() {
+        for (int state = 0; state < RENDER_STATE_COUNT; ++state) {
+            state_colors_[state] = averageColor(state_sprites_[state] ? state_sprites_[state] : sprSand.get());
+        }
+    }
+
+    static int cellPixelsAt(int zoom) { return zoom > 0 ? 1 << zoom : 1; }
+    static int cellsPerPixelAt(int zoom) { return zoom < 0 ? 1 << -zoom : 1; }
+    int visibleRowsAt(int zoom) const {
+        return (ScreenHeight() * cellsPerPixelAt(zoom) + cellPixelsAt(zoom) - 1) / cellPixelsAt(zoom);
+    }
+    int visibleColsAt(int zoom) const {
+        return (ScreenWidth() * cellsPerPixelAt(zoom) + cellPixelsAt(zoom) - 1) / cellPixelsAt(zoom);
+    }
+    int cellPixels() const { return cellPixelsAt(zoom_); }
+    int cellsPerPixel() const { return cellsPerPixelAt(zoom_); }
+    int visibleRows() const { return visibleRowsAt(zoom_); }
+    int visibleCols() const { return visibleColsAt(zoom_); }
+
+    void clampView() {
+        view_r_ = std::max(0, std::min(view_r_, ocean_rows_ - visibleRows()));
+        view_c_ = std::max(0, std::min(view_c_, ocean_cols_ - visibleCols()));
+    }
+
+    // Zoom keeps the cell at the center of the window in place.
+    void setZoom(int zoom) {
+        zoom = std::max(min_zoom_, std::min(zoom, ZOOM_SPRITES));
+        if (zoom == zoom_) {
+            return;
+        }
+        const int center_r = view_r_ + visibleRows() / 2;
+        const int center_c = view_c_ + visibleCols() / 2;
+        const bool was_sprites = zoom_ >= ZOOM_SPRITES;
+        zoom_ = zoom;
+        view_r_ = center_r - visibleRows() / 2;
+        view_c_ = center_c - visibleCols() / 2;
+        clampView();
+        if (was_sprites != (zoom_ >= ZOOM_SPRITES)) {
+            EnableLayer(sand_layer_, zoom_ >= ZOOM_SPRITES);
+            EnableLayer(entity_layer_, zoom_ >= ZOOM_SPRITES);
+            SetDrawTarget(nullptr);
+            Clear(zoom_ >= ZOOM_SPRITES ? olc::BLANK : olc::BLACK);
+        }
+        full_repaint_ = true;
+    }
+
+    // Arrows or WASD pan by half a window per second; the mouse wheel or
+    // Q/E zoom.
+    void handleViewInput(float fElapsedTime) {
+        int zoom = zoom_;
+        if (GetMouseWheel() > 0 || GetKey(olc::Key::E).bPressed) {
+            ++zoom;
+        }
+        if (GetMouseWheel() < 0 || GetKey(olc::Key::Q).bPressed) {
+            --zoom;
+        }
+        setZoom(zoom);
+
+        const float rows_per_second = 0.5f * static_cast<float>(visibleRows());
+        const float cols_per_second = 0.5f * static_cast<float>(visibleCols());
+        if (GetKey(olc::Key::UP).bHeld || GetKey(olc::Key::W).bHeld) pan_r_ -= rows_per_second * fElapsedTime;
+        if (GetKey(olc::Key::DOWN).bHeld || GetKey(olc::Key::S).bHeld) pan_r_ += rows_per_second * fElapsedTime;
+        if (GetKey(olc::Key::LEFT).bHeld || GetKey(olc::Key::A).bHeld) pan_c_ -= cols_per_second * fElapsedTime;
+        if (GetKey(olc::Key::RIGHT).bHeld || GetKey(olc::Key::D).bHeld) pan_c_ += cols_per_second * fElapsedTime;
+        const int step_r = static_cast<int>(pan_r_);
+        const int step_c = static_cast<int>(pan_c_);
+        pan_r_ -= static_cast<float>(step_r);
+        pan_c_ -= static_cast<float>(step_c);
+        if (step_r != 0 || step_c != 0) {
+            const int old_r = view_r_;
+            const int old_c = view_c_;
+            view_r_ += step_r;
+            view_c_ += step_c;
+            clampView();
+            full_repaint_ = full_repaint_ || view_r_ != old_r || view_c_ != old_c;
+        }
+    }
+
+    // Expects the entity layer as draw target in Pixel::NORMAL mode, so the
+    // sprite's alpha is kept for compositing over the sand layer.
+    void drawCell(int idx, std::uint8_t state, bool clear) {
+        const int r = idx / ocean_cols_ - view_r_;
+        const int c = idx % ocean_cols_ - view_c_;
+        if (r < 0 || c < 0 || r >= visibleRows() || c >= visibleCols()) {
+            return;
+        }
+        const int x = c * SPRITE_SIZE;
+        const int y = r * SPRITE_SIZE;
+        if (clear) {
+            FillRect(x, y, SPRITE_SIZE, SPRITE_SIZE, olc::BLANK);
+        }
+        if (olc::Sprite* spriteToDraw = state_sprites_[state & (RENDER_STATE_COUNT - 1)]) {
+            DrawSprite(x, y, spriteToDraw);
+        }
+    }
+
+    void drawSprites(const std::vector<std::uint8_t>& states) {
+        SetDrawTarget(entity_layer_);
+        SetPixelMode(olc::Pixel::NORMAL);
+        if (full_repaint_) {
+            Clear(olc::BLANK);
+        }
+        const int rows = std::min(visibleRows(), ocean_rows_ - view_r_);
+        const int cols = std::min(visibleCols(), ocean_cols_ - view_c_);
+        for (int r = 0; r < rows; ++r) {
+            const int row_start = (view_r_ + r) * ocean_cols_ + view_c_;
+            for (int idx = row_start; idx < row_start + cols; ++idx) {
+                const std::uint8_t state = states[idx];
+                if (full_repaint_ ? state != 0 : state != drawn_states_[idx]) {
+                    drawCell(idx, state, !full_repaint_);
+                }
+                drawn_states_[idx] = state;
+            }
+        }
+        SetPixelMode(olc::Pixel::ALPHA);
+        SetDrawTarget(nullptr);
+    }
+
+    void drawOverview(const std::vector<std::uint8_t>& states) {
+        SetDrawTarget(nullptr);
+        olc::Sprite* target = GetDrawTarget();
+        olc::Pixel* pixels = target->GetData();
+        const int width = target->width;
+        const int height = target->height;
+        std::fill(pixels, pixels + static_cast<size_t>(width) * height, olc::BLACK);
+
+        if (zoom_ >= 0) {
+            const int size = cellPixels();
+            const int cols = std::min(visibleCols(), ocean_cols_ - view_c_);
+            const int rows = std::min(visibleRows(), ocean_rows_ - view_r_);
+            for (int y = 0; y < std::min(height, rows * size); ++y) {
+                const std::uint8_t* row = &states[static_cast<size_t>(view_r_ + y / size) * ocean_cols_ + view_c_];
+                olc::Pixel* out = pixels + static_cast<size_t>(y) * width;
+                for (int x = 0; x < std::min(width, cols * size); ++x) {
+                    out[x] = state_colors_[row[x / size] & (RENDER_STATE_COUNT - 1)];
+                }
+            }
+            return;
+        }
+
+        // Each output row sums its block of cell rows column by column, so
+        // the grid is read row-major once per frame.
+        const int block = cellsPerPixel();
+        block_sums_.assign(static_cast<size_t>(width) * 4, 0);
+        for (int y = 0; y < height; ++y) {
+            const int r_begin = view_r_ + y * block;
+            if (r_begin >= ocean_rows_) {
+                break;
+            }
+            const int r_end = std::min(r_begin + block, ocean_rows_);
+            std::fill(block_sums_.begin(), block_sums_.end(), 0);
+            for (int r = r_begin; r < r_end; ++r) {
+                const std::uint8_t* row = &states[static_cast<size_t>(r) * ocean_cols_];
+                for (int x = 0; x < width; ++x) {
+                    const int c_begin = view_c_ + x * block;
+                    if (c_begin >= ocean_cols_) {
+                        break;
+                    }
+                    const int c_end = std::min(c_begin + block, ocean_cols_);
+                    std::uint32_t* sum = &block_sums_[static_cast<size_t>(x) * 4];
+                    for (int c = c_begin; c < c_end; ++c) {
+                        const olc::Pixel color = state_colors_[row[c] & (RENDER_STATE_COUNT - 1)];
+                        sum[0] += color.r;
+                        sum[1] += color.g;
+                        sum[2] += color.b;
+                        sum[3] += 1;
+                    }
+                }
+            }
+            olc::Pixel* out = pixels + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                const std::uint32_t* sum = &block_sums_[static_cast<size_t>(x) * 4];
+                if (sum[3] > 0) {
+                    out[x] = olc::Pixel(static_cast<uint8_t>(sum[0] / sum[3]), static_cast<uint8_t>(sum[1] / sum[3]),
+                                        static_cast<uint8_t>(sum[2] / sum[3]));
+                }
+            }
+        }
+    }
+
+    // Simulation thread only, apart from the first call in OnUserCreate
+    // before the thread starts.
+    void publishSnapshot() {
+        OceanSnapshot& snapshot = snapshots_.writeBuffer();
+        snapshot.states = pge_ocean_->getRenderStates();
+        snapshots_.publish();
+    }
+
+    // Sleeps in short slices so that OnUserDestroy never waits out a whole
+    // interval. A tick longer than the interval delays the next one instead
+    // of queueing a burst of catch-up ticks.
+    void simulationLoop() {
+        using Clock = std::chrono::steady_clock;
+        const auto interval = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(TICK_INTERVAL));
+        auto next_tick = Clock::now() + interval;
+        try {
+            while (sim_running_.load(std::memory_order_acquire)) {
+                const auto now = Clock::now();
+                if (sim_unthrottled_.load(std::memory_order_relaxed)) {
+                    next_tick = now;
+                } else if (now < next_tick) {
+                    std::this_thread::sleep_for(std::min<Clock::duration>(next_tick - now, std::chrono::milliseconds(10)));
+                    continue;
+                } else {
+                    next_tick = std::max(next_tick + interval, now);
+                }
+                pge_ocean_->tick();
+                publishSnapshot();
+            }
+        } catch (const std::exception& e) {
+            Logger::error("PGE: simulation thread stopped: ", e.what());
+        }
+    }
 
 public:
     bool OnUserCreate() override {
@@ -110,13 +420,15 @@ public:
     }
     
     Logger::info("PGE: Hungry sprites created and modified.");
+    buildStateSprites();
+    buildStateColors();
 
 
     int initial_algae_count = 0;
     for(int i = 0; i < ocean_rows_ * ocean_cols_ / 15; ++i) { // вместо ocean_rows_ * ocean_cols_ / 15 можно написать точное число водорослей
         int r = Random::getInt(0, pge_ocean_->getRows()-1);
         int c = Random::getInt(0, pge_ocean_->getCols()-1);
-        if(pge_ocean_->addEntity(std::make_unique<Algae>(), r, c)) {
+        if(pge_ocean_->addEntity(pge_ocean_->createEntity<Algae>(), r, c)) {
             initial_algae_count++;
         }
     }
@@ -126,7 +438,7 @@ public:
     for(int i=0; i < ocean_rows_ * ocean_cols_ / 100; ++i) { // вместо ocean_rows_ * ocean_cols_ / 100 можно написать точное число травоядных
         int r = Random::getInt(0, pge_ocean_->getRows()-1);
         int c = Random::getInt(0, pge_ocean_->getCols()-1);
-        if(pge_ocean_->addEntity(std::make_unique<HerbivoreFish>(), r, c)) {
+        if(pge_ocean_->addEntity(pge_ocean_->createEntity<HerbivoreFish>(), r, c)) {
             initial_herb_count++;
         }
     }
@@ -136,78 +448,78 @@ public:
     for(int i=0; i < ocean_rows_ * ocean_cols_ / 300; ++i) { // вместо ocean_rows_ * ocean_cols_ / 300 можно написать точное число хищников
         int r = Random::getInt(0, pge_ocean_->getRows()-1);
         int c = Random::getInt(0, pge_ocean_->getCols()-1);
-        if(pge_ocean_->addEntity(std::make_unique<PredatorFish>(), r, c)) {
+        if(pge_ocean_->addEntity(pge_ocean_->createEntity<PredatorFish>(), r, c)) {
             initial_pred_count++;
         }
     }
     Logger::info("Added ", initial_pred_count, " PredatorFish initially.");
+
+    entity_layer_ = static_cast<uint8_t>(CreateLayer());
+    sand_layer_ = static_cast<uint8_t>(CreateLayer());
+    SetDrawTarget(sand_layer_);
+    Clear(olc::BLACK);
+    for (int y = 0; y < ScreenHeight(); y += SPRITE_SIZE) {
+        for (int x = 0; x < ScreenWidth(); x += SPRITE_SIZE) {
+            DrawSprite(x, y, sprSand.get());
+        }
+    }
+    EnableLayer(sand_layer_, true);
+    EnableLayer(entity_layer_, true);
+    drawn_states_.assign(static_cast<size_t>(ocean_rows_) * ocean_cols_, 0);
+    SetDrawTarget(nullptr);
+    Clear(olc::BLANK);
+
+    // Zooming out stops once the whole ocean fits; start at the closest
+    // zoom that shows all of it.
+    while (min_zoom_ > ZOOM_MIN && (visibleRowsAt(min_zoom_) < ocean_rows_ || visibleColsAt(min_zoom_) < ocean_cols_)) {
+        --min_zoom_;
+    }
+    int fit_zoom = ZOOM_SPRITES;
+    while (fit_zoom > min_zoom_ && (visibleRowsAt(fit_zoom) < ocean_rows_ || visibleColsAt(fit_zoom) < ocean_cols_)) {
+        --fit_zoom;
+    }
+    setZoom(fit_zoom);
+
+    publishSnapshot();
+    sim_running_.store(true, std::memory_order_release);
+    sim_thread_ = std::thread(&OceanGame::simulationLoop, this);
+    Logger::info("PGE: arrows/WASD pan, mouse wheel or Q/E zoom, F toggles unthrottled ticking.");
     Logger::info("PGE: OnUserCreate finished.");
     return true;
 }
 
     bool OnUserUpdate(float fElapsedTime) override {
-        time_accumulator_ += fElapsedTime;
-
         if (GetKey(olc::Key::ESCAPE).bPressed) {
             return false; 
         }
-        
-        if (time_accumulator_ >= TICK_INTERVAL) {
-            time_accumulator_ -= TICK_INTERVAL;
-            if (pge_ocean_) {
-                pge_ocean_->tick();
-            }
+
+        if (GetKey(olc::Key::F).bPressed) {
+            const bool unthrottled = !sim_unthrottled_.load(std::memory_order_relaxed);
+            sim_unthrottled_.store(unthrottled, std::memory_order_relaxed);
+            Logger::info("PGE: simulation ", unthrottled ? "unthrottled." : "throttled to one tick per interval.");
         }
 
-        Clear(olc::BLACK);
-
-        if (pge_ocean_) {
-            for (int r = 0; r < pge_ocean_->getRows(); ++r) {
-                for (int c = 0; c < pge_ocean_->getCols(); ++c) {
-                    DrawSprite(c * SPRITE_SIZE, r * SPRITE_SIZE, sprSand.get());
-                    olc::Sprite* spriteToDraw = nullptr;
-                    Entity* entity = nullptr;
-                    try {
-                        entity = pge_ocean_->getEntity(r, c);
-                    } catch (const std::out_of_range& e) {
-                        Logger::error("Error getting entity at (", r, ",", c, "): ", e.what());
-                        continue; 
-                    }
-                    
-                    if (entity) {
-                        switch (entity->getType()) {
-                            case EntityType::ALGAE:
-                                spriteToDraw = sprAlgae.get();
-                                break;
-                            case EntityType::HERBIVORE:
-                                {
-                                    HerbivoreFish* hf = dynamic_cast<HerbivoreFish*>(entity);
-                                    if (hf && hf->getSymbol() == 'h') spriteToDraw = sprHerbivoreHungry.get();
-                                    else spriteToDraw = sprHerbivore.get();
-                                }
-                                break;
-                            case EntityType::PREDATOR:
-                                {
-                                    PredatorFish* pf = dynamic_cast<PredatorFish*>(entity);
-                                    if (pf && pf->getSymbol() == 'p') spriteToDraw = sprPredatorHungry.get();
-                                    else spriteToDraw = sprPredator.get();
-                                }
-                                break;
-                            default:
-                                break;
-                        }
-                    }
-                    if (spriteToDraw) {
-                        DrawSprite(c * SPRITE_SIZE, r * SPRITE_SIZE, spriteToDraw);
-                    }
-                }
+        handleViewInput(fElapsedTime);
+
+        const bool fresh = snapshots_.update();
+        if (full_repaint_ || fresh) {
+            const OceanSnapshot& snapshot = snapshots_.readBuffer();
+            if (zoom_ >= ZOOM_SPRITES) {
+                drawSprites(snapshot.states);
+            } else {
+                drawOverview(snapshot.states);
             }
+            full_repaint_ = false;
         }
         return true;
     }
 
     bool OnUserDestroy() override {
         Logger::info("PGE: OnUserDestroy called.");
+        sim_running_.store(false, std::memory_order_release);
+        if (sim_thread_.joinable()) {
+            sim_thread_.join();
+        }
         delete pge_ocean_;
         pge_ocean_ = nullptr;
         return true;
@@ -276,7 +588,8 @@ void demonstrateRuleOfFive() {
 }
 
 
-int main() {
+// Usage: OceanSimulation [rows cols]
+int main(int argc, char* argv[]) {
     LoggerInitializer logger_guard; 
     Logger::info("Main: Program starting...");
 
@@ -290,9 +603,15 @@ int main() {
 
     int ocean_sim_rows = 50; 
     int ocean_sim_cols = 50; 
+    if (argc >= 3) {
+        ocean_sim_rows = std::max(1, std::atoi(argv[1]));
+        ocean_sim_cols = std::max(1, std::atoi(argv[2]));
+    }
 
+    const int view_rows = std::min(ocean_sim_rows, MAX_VIEW_CELLS);
+    const int view_cols = std::min(ocean_sim_cols, MAX_VIEW_CELLS);
     OceanGame game(ocean_sim_rows, ocean_sim_cols);
-    if (game.Construct(ocean_sim_cols * SPRITE_SIZE, ocean_sim_rows * SPRITE_SIZE, 4, 4)) {
+    if (game.Construct(view_cols * SPRITE_SIZE, view_rows * SPRITE_SIZE, 1, 1)) {
         Logger::info("Main: PGE Constructed, starting game loop.");
         game.Start();
     } else {
@@ -1,7 +1,15 @@
 #include "ocean.hpp"        
+#include "algae.hpp"
+#include "herbivore.hpp"
+#include "predator.hpp"
 #include "utils/logger.hpp" 
+#include "utils/event_log.hpp"
 #include "utils/random.hpp" 
+#include "utils/ring_buffer.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/tick_profiler.hpp"
 
+#include <atomic>
 #include <vector>
 #include <memory>
 #include <stdexcept>
@@ -9,25 +17,390 @@
 #include <algorithm>    
 #include <string> // Для std::to_string
 
+namespace {
+constexpr std::uint32_t DEATH_LOG_LINES_PER_SECOND = 100;
+}
+
 class Ocean::OceanImpl {
 public:
     int rows_;
     int cols_;
-    std::vector<std::vector<std::unique_ptr<Entity>>> grid_;
+    // Declared before cells_ so that pooled entities are released while the
+    // pool is still alive.
+    EntityPool pool_;
+    // Row-major cell storage: index = r * cols_ + c. The type/energy/age planes
+    // mirror the owning entity so that neighborhood and sight scans only touch
+    // dense bytes instead of dereferencing Entity*.
+    std::vector<EntityPtr> cells_;
+    std::vector<EntityType> type_plane_;
+    std::vector<int> energy_plane_;
+    std::vector<int> age_plane_;
+    // Render state per cell (see RENDER_TYPE_MASK), derived from the type,
+    // energy and age planes.
+    std::vector<std::uint8_t> render_plane_;
+    DispatchMode dispatch_mode_ = DispatchMode::VIRTUAL;
+
+    // Registry of occupied cells, kept by add/remove/move so that a tick costs
+    // O(population) instead of O(rows * cols). active_slot_[idx] is the
+    // position of idx in active_, -1 for an empty cell, or PENDING_SLOT for a
+    // cell filled during a parallel phase (see deferred_registry_).
+    static constexpr int PENDING_SLOT = -2;
+    std::vector<int> active_;
+    std::vector<int> active_slot_;
+    bool deferred_registry_ = false;
+
+    // Cells and, when energy tracking is on, total energy per EntityType
+    // (SAND counts empty cells), adjusted by every plane write so that
+    // population queries are O(1). During a parallel phase each worker keeps
+    // its own delta, folded in by mergeDeferredRegistry().
+    static constexpr int TYPE_COUNT = static_cast<int>(EntityType::PREDATOR) + 1;
+    struct PopulationCounters {
+        long long count[TYPE_COUNT] = {};
+        long long energy[TYPE_COUNT] = {};
+    };
+    PopulationCounters population_;
+    bool track_energy_ = false;
+    static constexpr size_t DEFAULT_POPULATION_HISTORY = 1024;
+    RingBuffer<PopulationStats> population_history_{DEFAULT_POPULATION_HISTORY};
+
+    // Cells whose render state changed since the last clearDirtyCells(),
+    // each listed once (dirty_flag_ marks membership). Parallel workers park
+    // theirs in WorkerContext::dirty_cells until mergeDeferredRegistry().
+    bool track_dirty_ = false;
+    std::vector<std::uint8_t> dirty_flag_;
+    std::vector<int> dirty_cells_;
+
+    // State of one thread running entity updates: the cell of the entity whose
+    // update is running (followed through its own moves), entities that died
+    // during this tick, cells added during a parallel phase, and scratch
+    // buffers. The serial tick uses workers_[0]. `profile` collects this
+    // thread's species times and counters during a profiled tick.
+    struct WorkerContext {
+        const OceanImpl* owner = nullptr;
+        int actor_idx = -1;
+        std::vector<std::pair<int, const Entity*>> dead;
+        std::vector<int> pending_cells;
+        std::vector<int> order;
+        std::vector<int> species_order[3];
+        TickProfile profile;
+        PopulationCounters population;
+        std::vector<int> dirty_cells;
+    };
+    std::vector<WorkerContext> workers_;
+    inline static thread_local WorkerContext* current_worker_ = nullptr;
+
+    // Points this thread's current_worker_ at a context for the scope, so a
+    // task that throws does not leave a pool thread pointing at it.
+    class CurrentWorkerScope {
+    public:
+        explicit CurrentWorkerScope(WorkerContext& context) { current_worker_ = &context; }
+        ~CurrentWorkerScope() { current_worker_ = nullptr; }
+        CurrentWorkerScope(const CurrentWorkerScope&) = delete;
+        CurrentWorkerScope& operator=(const CurrentWorkerScope&) = delete;
+    };
+
+    // Tile-parallel tick: tiles of tile_size_ x tile_size_ cells in a 2x2
+    // coloring; tiles of one color are updated concurrently.
+    static constexpr int MIN_TILE_SIZE = Config::PREDATOR_SIGHT_RADIUS + 2;
+    static constexpr int DEFAULT_TILE_SIZE = 32;
+    int tile_size_ = DEFAULT_TILE_SIZE;
+    std::unique_ptr<ThreadPool> thread_pool_;
+    std::vector<std::vector<int>> tile_cells_;
+    std::vector<int> color_tiles_[4];
+
+    // Per-tick distance fields towards the nearest ALGAE (for herbivores) and
+    // the nearest HERBIVORE (for predators). See prepareFlowFields().
+    struct FlowField {
+        EntityType target = EntityType::SAND;
+        int radius = 0;
+        bool active = false;
+        uint32_t generation = 0;
+        std::vector<uint32_t> stamp;  // cell reached in this generation
+        std::vector<int> nearest;     // index of the nearest target cell
+        std::vector<int> dist_sq;     // squared distance to it
+        // Build scratch: per cell, the nearest target row strictly below it
+        // in its column; per column, the nearest candidate rows of the row
+        // being built.
+        std::vector<int> below;
+        std::vector<int> column_above;
+        std::vector<int> inclusive_key;
+        std::vector<int> best_key;
+    };
+    static constexpr int FLOW_FIELD_COUNT = 2;
+    FlowField flow_fields_[FLOW_FIELD_COUNT];
+    FlowFieldMode flow_field_mode_ = FlowFieldMode::AUTO;
+    // Set when the fields are built and cleared by the first change of the
+    // type plane after that. While set, a cell with no target in its window
+    // has none on the grid either, so lookups need no direct search; this
+    // holds through the whole planning phase of an INTENT tick. Atomic
+    // because parallel in-place workers clear it concurrently.
+    std::atomic<bool> flow_fields_current_{false};
+
+    UpdateMode update_mode_ = UpdateMode::IN_PLACE;
+    unsigned long long tick_count_ = 0;
+    std::uint64_t intent_seed_ = 0;
+
+    // One entry per entity in UpdateMode::INTENT, ordered by priority before
+    // the resolve phase.
+    struct PlannedUpdate {
+        std::uint64_t priority;
+        int idx;
+        Entity* entity;
+        Intent intent;
+    };
+    static constexpr int PLANS_PER_TASK = 1024;
+
+    // Opt-in tick profiling. profile_tick_ is set only while a profiled tick
+    // runs, so grid operations made between ticks are not counted.
+    TickProfiler profiler_;
+    bool profiling_ = false;
+    bool profile_tick_ = false;
+    TickProfile tick_profile_;
+
+    // Per-tick scratch buffers, reused so that a steady-state tick does not allocate.
+    std::vector<PlannedUpdate> plans_;
 
     OceanImpl(int rows, int cols) 
         : rows_(rows), cols_(cols) {
-        grid_.resize(rows_);
-        for (int i = 0; i < rows_; ++i) {
-            grid_[i].resize(cols_); 
+        const size_t area = static_cast<size_t>(rows_) * static_cast<size_t>(cols_);
+        cells_.resize(area);
+        type_plane_.assign(area, EntityType::SAND);
+        energy_plane_.assign(area, 0);
+        age_plane_.assign(area, 0);
+        render_plane_.assign(area, static_cast<std::uint8_t>(EntityType::SAND));
+        active_slot_.assign(area, -1);
+        population_.count[static_cast<int>(EntityType::SAND)] = static_cast<long long>(area);
+        flow_fields_[0].target = EntityType::ALGAE;
+        flow_fields_[0].radius = Config::HERBIVORE_SIGHT_RADIUS;
+        flow_fields_[1].target = EntityType::HERBIVORE;
+        flow_fields_[1].radius = Config::PREDATOR_SIGHT_RADIUS;
+        setThreadCountImpl(1);
+        intent_seed_ = Random::getGenerator()();
+    }
+
+    WorkerContext& worker() {
+        WorkerContext* current = current_worker_;
+        return (current && current->owner == this) ? *current : workers_[0];
+    }
+
+    // Constant false when the profiler is compiled out, so every hook that
+    // tests it is discarded.
+    bool profilingTick() const {
+        if constexpr (TickProfiler::COMPILED) {
+            return profile_tick_;
+        } else {
+            return false;
+        }
+    }
+
+    // Charges the time since `mark` to `type` and moves the mark forward, so
+    // consecutive updates cost one clock read each.
+    static void chargeSpecies(WorkerContext& context, EntityType type, TickProfiler::Clock::time_point& mark) {
+        const TickProfiler::Clock::time_point now = TickProfiler::Clock::now();
+        context.profile.species_ns[profiledSpeciesSlot(type)] += TickProfiler::nanosBetween(mark, now);
+        mark = now;
+    }
+
+    void setThreadCountImpl(int thread_count) {
+        if (thread_count <= 0) {
+            thread_count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        }
+        thread_pool_.reset();
+        workers_.clear();
+        workers_.resize(thread_count);
+        for (WorkerContext& context : workers_) {
+            context.owner = this;
+        }
+        if (thread_count > 1) {
+            thread_pool_ = std::make_unique<ThreadPool>(thread_count);
         }
     }
 
+    int indexOf(int r, int c) const {
+        return r * cols_ + c;
+    }
+
     bool isValidCoordinateImpl(int r, int c) const {
         return r >= 0 && r < rows_ && c >= 0 && c < cols_;
     }
 
-    bool addEntityImpl(std::unique_ptr<Entity> entity, int r, int c) {
+    void markDirty(int idx) {
+        if (track_dirty_ && !dirty_flag_[idx]) {
+            dirty_flag_[idx] = 1;
+            (deferred_registry_ ? worker().dirty_cells : dirty_cells_).push_back(idx);
+        }
+    }
+
+    void setDirtyTrackingImpl(bool enabled) {
+        track_dirty_ = enabled;
+        dirty_cells_.clear();
+        if (enabled) {
+            dirty_flag_.assign(cells_.size(), 0);
+        } else {
+            dirty_flag_.clear();
+            dirty_flag_.shrink_to_fit();
+        }
+    }
+
+    void clearDirtyCellsImpl() {
+        for (int idx : dirty_cells_) {
+            dirty_flag_[idx] = 0;
+        }
+        dirty_cells_.clear();
+    }
+
+    PopulationCounters& populationCounters() {
+        return deferred_registry_ ? worker().population : population_;
+    }
+
+    static std::uint8_t renderStateOf(EntityType type, int energy, int age) {
+        std::uint8_t state = static_cast<std::uint8_t>(type);
+        switch (type) {
+            case EntityType::HERBIVORE:
+                if (HerbivoreFish::isDying(energy, age)) {
+                    state |= RENDER_DYING;
+                } else if (HerbivoreFish::isStarving(energy)) {
+                    state |= RENDER_HUNGRY;
+                }
+                break;
+            case EntityType::PREDATOR:
+                if (PredatorFish::isDying(energy, age)) {
+                    state |= RENDER_DYING;
+                } else if (PredatorFish::isStarving(energy)) {
+                    state |= RENDER_HUNGRY;
+                }
+                break;
+            default:
+                break;
+        }
+        return state;
+    }
+
+    void setRenderState(int idx) {
+        const std::uint8_t state = renderStateOf(type_plane_[idx], energy_plane_[idx], age_plane_[idx]);
+        if (state != render_plane_[idx]) {
+            render_plane_[idx] = state;
+            markDirty(idx);
+        }
+    }
+
+    void syncPlanes(int idx) {
+        const EntityType old_type = type_plane_[idx];
+        const int old_energy = energy_plane_[idx];
+        const Entity* entity = cells_[idx].get();
+        if (entity) {
+            type_plane_[idx] = entity->getType();
+            energy_plane_[idx] = entity->getEnergy();
+            age_plane_[idx] = entity->getAge();
+        } else {
+            type_plane_[idx] = EntityType::SAND;
+            energy_plane_[idx] = 0;
+            age_plane_[idx] = 0;
+        }
+        setRenderState(idx);
+        const EntityType new_type = type_plane_[idx];
+        if (old_type != new_type) {
+            noteTypeChange();
+        }
+        if (old_type != new_type || (track_energy_ && old_energy != energy_plane_[idx])) {
+            PopulationCounters& counters = populationCounters();
+            counters.count[static_cast<int>(old_type)]--;
+            counters.count[static_cast<int>(new_type)]++;
+            if (track_energy_) {
+                counters.energy[static_cast<int>(old_type)] -= old_energy;
+                counters.energy[static_cast<int>(new_type)] += energy_plane_[idx];
+            }
+        }
+    }
+
+    void noteTypeChange() {
+        if (flow_fields_current_.load(std::memory_order_relaxed)) {
+            flow_fields_current_.store(false, std::memory_order_relaxed);
+        }
+    }
+
+    // Plane update after an actor's own update, where only its energy and
+    // age can have changed.
+    void setActorPlanes(int idx, int energy, int age) {
+        if (track_energy_) {
+            populationCounters().energy[static_cast<int>(type_plane_[idx])] += energy - energy_plane_[idx];
+        }
+        energy_plane_[idx] = energy;
+        age_plane_[idx] = age;
+        setRenderState(idx);
+    }
+
+    // While deferred_registry_ is set, workers only touch their own cells and
+    // their own registry slot: removals leave a -1 tombstone in active_ and
+    // additions are parked in the worker's pending_cells until
+    // mergeDeferredRegistry() runs on the tick thread.
+    void registerCell(int idx) {
+        if (deferred_registry_) {
+            active_slot_[idx] = PENDING_SLOT;
+            worker().pending_cells.push_back(idx);
+            return;
+        }
+        active_slot_[idx] = static_cast<int>(active_.size());
+        active_.push_back(idx);
+    }
+
+    void unregisterCell(int idx) {
+        const int slot = active_slot_[idx];
+        if (deferred_registry_) {
+            if (slot >= 0) {
+                active_[slot] = -1;
+            }
+            active_slot_[idx] = -1;
+            return;
+        }
+        const int last = active_.back();
+        active_[slot] = last;
+        active_slot_[last] = slot;
+        active_.pop_back();
+        active_slot_[idx] = -1;
+    }
+
+    void moveRegisteredCell(int from, int to) {
+        const int slot = active_slot_[from];
+        if (slot == PENDING_SLOT) {
+            worker().pending_cells.push_back(to);
+        } else {
+            active_[slot] = to;
+        }
+        active_slot_[to] = slot;
+        active_slot_[from] = -1;
+    }
+
+    void mergeDeferredRegistry() {
+        size_t kept = 0;
+        for (size_t slot = 0; slot < active_.size(); ++slot) {
+            const int idx = active_[slot];
+            if (idx >= 0) {
+                active_[kept] = idx;
+                active_slot_[idx] = static_cast<int>(kept);
+                ++kept;
+            }
+        }
+        active_.resize(kept);
+        for (WorkerContext& context : workers_) {
+            for (int idx : context.pending_cells) {
+                if (active_slot_[idx] == PENDING_SLOT) {
+                    active_slot_[idx] = static_cast<int>(active_.size());
+                    active_.push_back(idx);
+                }
+            }
+            context.pending_cells.clear();
+            for (int t = 0; t < TYPE_COUNT; ++t) {
+                population_.count[t] += context.population.count[t];
+                population_.energy[t] += context.population.energy[t];
+            }
+            context.population = PopulationCounters{};
+            dirty_cells_.insert(dirty_cells_.end(), context.dirty_cells.begin(), context.dirty_cells.end());
+            context.dirty_cells.clear();
+        }
+    }
+
+    bool addEntityImpl(EntityPtr entity, int r, int c) {
         if (!entity) {
             Logger::warn("Attempted to add a null entity to (", r, ",", c, ").");
             return false;
@@ -38,11 +411,17 @@ public:
             Logger::error(err_msg);
             throw std::out_of_range(err_msg);
         }
-        if (grid_[r][c]) { 
-            Logger::debug("Cannot add entity: cell (", r, ",", c, ") is already occupied by type ", static_cast<int>(grid_[r][c]->getType()), ". Requested type: ", static_cast<int>(entity->getType()));
+        const int idx = indexOf(r, c);
+        if (cells_[idx]) { 
+            Logger::debug("Cannot add entity: cell (", r, ",", c, ") is already occupied by type ", static_cast<int>(type_plane_[idx]), ". Requested type: ", static_cast<int>(entity->getType()));
             return false; 
         }
-        grid_[r][c] = std::move(entity); 
+        cells_[idx] = std::move(entity); 
+        syncPlanes(idx);
+        registerCell(idx);
+        if (profilingTick()) {
+            worker().profile.births++;
+        }
         return true;
     }
 
@@ -53,20 +432,30 @@ public:
             Logger::error(err_msg);
             throw std::out_of_range(err_msg);
         }
-        return grid_[r][c].get(); 
+        return cells_[indexOf(r, c)].get(); 
     }
 
-    std::unique_ptr<Entity> removeEntityImpl(int r, int c) {
+    EntityPtr removeEntityImpl(int r, int c) {
         if (!isValidCoordinateImpl(r, c)) {
             std::string err_msg = "removeEntityImpl: Coordinates (" + std::to_string(r) + "," + std::to_string(c) + 
                                   ") are outside ocean bounds (" + std::to_string(rows_) + "x" + std::to_string(cols_) + ").";
             Logger::error(err_msg);
             throw std::out_of_range(err_msg);
         }
-        if (!grid_[r][c]) {
+        const int idx = indexOf(r, c);
+        if (!cells_[idx]) {
             return nullptr; 
         }
-        return std::move(grid_[r][c]); 
+        EntityPtr removed = std::move(cells_[idx]);
+        syncPlanes(idx);
+        unregisterCell(idx);
+        WorkerContext& context = worker();
+        if (idx == context.actor_idx) {
+            context.actor_idx = -1;
+        } else if (profilingTick()) {
+            context.profile.eats++;
+        }
+        return removed; 
     }
 
     bool moveEntityImpl(int r_from, int c_from, int r_to, int c_to) {
@@ -82,133 +471,749 @@ public:
             Logger::error(err_msg);
             throw std::out_of_range(err_msg);
         }
-        if (!grid_[r_from][c_from]) {
+        const int from = indexOf(r_from, c_from);
+        const int to = indexOf(r_to, c_to);
+        if (!cells_[from]) {
             Logger::warn("No entity at source location (", r_from, ",", c_from, ") to move.");
             return false;
         }
-        if (r_from == r_to && c_from == c_to) {
+        if (from == to) {
             return true; 
         }
-        if (grid_[r_to][c_to]) {
-            Logger::debug("Destination cell (", r_to, ",", c_to, ") for move is occupied by type ", static_cast<int>(grid_[r_to][c_to]->getType()), ". Source type: ", static_cast<int>(grid_[r_from][c_from]->getType()));
+        if (cells_[to]) {
+            Logger::debug("Destination cell (", r_to, ",", c_to, ") for move is occupied by type ", static_cast<int>(type_plane_[to]), ". Source type: ", static_cast<int>(type_plane_[from]));
             return false; 
         }
-        grid_[r_to][c_to] = std::move(grid_[r_from][c_from]); 
+        cells_[to] = std::move(cells_[from]); 
+        type_plane_[to] = type_plane_[from];
+        energy_plane_[to] = energy_plane_[from];
+        age_plane_[to] = age_plane_[from];
+        render_plane_[to] = render_plane_[from];
+        type_plane_[from] = EntityType::SAND;
+        energy_plane_[from] = 0;
+        age_plane_[from] = 0;
+        render_plane_[from] = static_cast<std::uint8_t>(EntityType::SAND);
+        noteTypeChange();
+        markDirty(from);
+        markDirty(to);
+        moveRegisteredCell(from, to);
+        WorkerContext& context = worker();
+        if (from == context.actor_idx) {
+            context.actor_idx = to;
+        }
+        if (profilingTick()) {
+            context.profile.moves++;
+        }
         return true;
     }
 
     void displayImpl() const {
+        std::string line(static_cast<size_t>(cols_) * 2, ' ');
         for (int r_idx = 0; r_idx < rows_; ++r_idx) {
+            const std::uint8_t* row = &render_plane_[static_cast<size_t>(indexOf(r_idx, 0))];
             for (int c_idx = 0; c_idx < cols_; ++c_idx) {
-                if (grid_[r_idx][c_idx]) {
-                    std::cout << grid_[r_idx][c_idx]->getSymbol() << " ";
-                } else {
-                    std::cout << ". "; 
-                }
+                line[static_cast<size_t>(c_idx) * 2] = renderStateSymbol(row[c_idx]);
             }
-            std::cout << std::endl;
+            std::cout << line << std::endl;
         }
         std::cout << std::endl; 
     }
 
-    void tickImpl(Ocean& ocean_ref) {
-        std::vector<std::pair<int,int>> entities_to_update;
-        for (int r_idx = 0; r_idx < rows_; ++r_idx) {
-            for (int c_idx = 0; c_idx < cols_; ++c_idx) {
-                if (grid_[r_idx][c_idx]) {
-                    entities_to_update.push_back({r_idx,c_idx});
+    template<typename T>
+    void updateSpecies(Ocean& ocean_ref, WorkerContext& context, const std::vector<int>& indices) {
+        const bool profiling = profilingTick();
+        TickProfiler::Clock::time_point mark;
+        if (profiling) {
+            mark = TickProfiler::Clock::now();
+        }
+        std::uint64_t updated = 0;
+        for (int idx : indices) {
+            if (type_plane_[idx] == T::TYPE) {
+                ++updated;
+                T* entity = static_cast<T*>(cells_[idx].get());
+                context.actor_idx = idx;
+                entity->T::update(ocean_ref, idx / cols_, idx % cols_);
+                const int actor_idx = context.actor_idx;
+                if (actor_idx >= 0) {
+                    if (entity->T::isDead()) {
+                        context.dead.push_back({actor_idx, entity});
+                    }
+                    setActorPlanes(actor_idx, entity->T::getEnergy(), entity->T::getAge());
                 }
             }
         }
-        Random::shuffle(entities_to_update);
+        context.actor_idx = -1;
+        if (profiling) {
+            chargeSpecies(context, T::TYPE, mark);
+            context.profile.updates += updated;
+        }
+    }
 
-        for (const auto& pos : entities_to_update) {
-            int r = pos.first;
-            int c = pos.second;
-            if (isValidCoordinateImpl(r,c) && grid_[r][c]) { 
-                grid_[r][c]->update(ocean_ref, r, c); 
+    void updateVirtual(Ocean& ocean_ref, WorkerContext& context, std::vector<int>& order) {
+        const bool profiling = profilingTick();
+        TickProfiler::Clock::time_point mark;
+        if (profiling) {
+            mark = TickProfiler::Clock::now();
+        }
+        Random::shuffle(order);
+        if (profiling) {
+            const TickProfiler::Clock::time_point shuffled = TickProfiler::Clock::now();
+            context.profile.phase_ns[static_cast<int>(TickPhase::COLLECT)] += TickProfiler::nanosBetween(mark, shuffled);
+            mark = shuffled;
+        }
+
+        for (int idx : order) {
+            Entity* entity = cells_[idx].get();
+            if (!entity) {
+                continue;
+            }
+            const EntityType type = type_plane_[idx];
+            context.actor_idx = idx;
+            entity->update(ocean_ref, idx / cols_, idx % cols_); 
+            const int actor_idx = context.actor_idx;
+            if (actor_idx >= 0) {
+                if (entity->isDead()) {
+                    context.dead.push_back({actor_idx, entity});
+                }
+                syncPlanes(actor_idx);
+            }
+            if (profiling) {
+                chargeSpecies(context, type, mark);
+                context.profile.updates++;
             }
         } 
+        context.actor_idx = -1;
+    }
 
-        int removed_count = 0;
-        for (int r_scan = 0; r_scan < rows_; ++r_scan) {
-            for (int c_scan = 0; c_scan < cols_; ++c_scan) {
-                if (isValidCoordinateImpl(r_scan,c_scan) && grid_[r_scan][c_scan]) {
-                    if (grid_[r_scan][c_scan]->isDead()) { 
-                        EntityType dead_entity_type = grid_[r_scan][c_scan]->getType(); 
-                        grid_[r_scan][c_scan].reset(); 
-                        Logger::info("Removed dead entity of type ", static_cast<int>(dead_entity_type), " at (", r_scan, ",", c_scan, ")");
-                        removed_count++;
+    // Species run in trophic order (algae, herbivores, predators), each group
+    // shuffled on its own, through direct calls on the final classes.
+    void updateBySpecies(Ocean& ocean_ref, WorkerContext& context, const std::vector<int>& order) {
+        const bool profiling = profilingTick();
+        TickProfiler::Clock::time_point start;
+        if (profiling) {
+            start = TickProfiler::Clock::now();
+        }
+        std::vector<int>& algae = context.species_order[0];
+        std::vector<int>& herbivores = context.species_order[1];
+        std::vector<int>& predators = context.species_order[2];
+        algae.clear();
+        herbivores.clear();
+        predators.clear();
+        for (int idx : order) {
+            switch (type_plane_[idx]) {
+                case EntityType::ALGAE:     algae.push_back(idx); break;
+                case EntityType::HERBIVORE: herbivores.push_back(idx); break;
+                case EntityType::PREDATOR:  predators.push_back(idx); break;
+                default: break;
+            }
+        }
+        Random::shuffle(algae);
+        Random::shuffle(herbivores);
+        Random::shuffle(predators);
+        if (profiling) {
+            context.profile.phase_ns[static_cast<int>(TickPhase::COLLECT)] += TickProfiler::nanosBetween(start, TickProfiler::Clock::now());
+        }
+
+        updateSpecies<Algae>(ocean_ref, context, algae);
+        updateSpecies<HerbivoreFish>(ocean_ref, context, herbivores);
+        updateSpecies<PredatorFish>(ocean_ref, context, predators);
+    }
+
+    void runUpdates(Ocean& ocean_ref, WorkerContext& context, std::vector<int>& order) {
+        if (dispatch_mode_ == DispatchMode::BY_SPECIES) {
+            updateBySpecies(ocean_ref, context, order);
+        } else {
+            updateVirtual(ocean_ref, context, order);
+        }
+    }
+
+    void updateSerial(Ocean& ocean_ref) {
+        WorkerContext& context = workers_[0];
+        const bool profiling = profilingTick();
+        TickProfiler::Clock::time_point start;
+        if (profiling) {
+            start = TickProfiler::Clock::now();
+        }
+        context.order.assign(active_.begin(), active_.end());
+        if (profiling) {
+            tick_profile_.phase_ns[static_cast<int>(TickPhase::COLLECT)] += TickProfiler::nanosBetween(start, TickProfiler::Clock::now());
+        }
+        runUpdates(ocean_ref, context, context.order);
+    }
+
+    // An update reads at most PREDATOR_SIGHT_RADIUS cells and writes at most
+    // one cell away from where the entity started, so with tiles of at least
+    // MIN_TILE_SIZE cells, tiles of the same color never touch the same cell.
+    // Each tile's entities are shuffled and updated in one task; colors run
+    // one after another.
+    void updateParallel(Ocean& ocean_ref) {
+        const bool profiling = profilingTick();
+        TickProfiler::Clock::time_point start;
+        if (profiling) {
+            start = TickProfiler::Clock::now();
+        }
+        const int tile_size = std::max(tile_size_, MIN_TILE_SIZE);
+        const int tile_rows = (rows_ + tile_size - 1) / tile_size;
+        const int tile_cols = (cols_ + tile_size - 1) / tile_size;
+        const size_t tile_count = static_cast<size_t>(tile_rows) * static_cast<size_t>(tile_cols);
+        if (tile_cells_.size() != tile_count) {
+            tile_cells_.assign(tile_count, {});
+            for (std::vector<int>& tiles : color_tiles_) {
+                tiles.clear();
+            }
+            for (int tr = 0; tr < tile_rows; ++tr) {
+                for (int tc = 0; tc < tile_cols; ++tc) {
+                    color_tiles_[(tr & 1) * 2 + (tc & 1)].push_back(tr * tile_cols + tc);
+                }
+            }
+        }
+        for (std::vector<int>& cells : tile_cells_) {
+            cells.clear();
+        }
+        for (int idx : active_) {
+            const int tile = (idx / cols_) / tile_size * tile_cols + (idx % cols_) / tile_size;
+            tile_cells_[tile].push_back(idx);
+        }
+        if (profiling) {
+            tick_profile_.phase_ns[static_cast<int>(TickPhase::COLLECT)] += TickProfiler::nanosBetween(start, TickProfiler::Clock::now());
+        }
+
+        const std::uint32_t event_tick = static_cast<std::uint32_t>(tick_count_);
+        deferred_registry_ = true;
+        pool_.setConcurrent(true);
+        try {
+            for (const std::vector<int>& tiles : color_tiles_) {
+                thread_pool_->run(static_cast<int>(tiles.size()), [&](int task, int worker_index) {
+                    WorkerContext& context = workers_[worker_index];
+                    EventLog::setTick(event_tick);
+                    {
+                        CurrentWorkerScope scope(context);
+                        runUpdates(ocean_ref, context, tile_cells_[tiles[task]]);
                     }
+                    Logger::flushThreadBuffer();
+                });
+            }
+        } catch (...) {
+            deferred_registry_ = false;
+            pool_.setConcurrent(false);
+            mergeDeferredRegistry();
+            throw;
+        }
+        deferred_registry_ = false;
+        pool_.setConcurrent(false);
+        mergeDeferredRegistry();
+    }
+
+    // Phase 1 plans every entity against the unchanged grid, in parallel when
+    // a thread pool is configured; each entity draws from its own stream
+    // seeded by (seed, tick, cell), so plans do not depend on scheduling.
+    // Phase 2 applies the plans one by one in an order given by a hash of the
+    // same key: when two plans claim the same cell, the higher-priority one
+    // wins and the other finds the cell taken. The outcome is a deterministic
+    // function of the seed and the starting grid.
+    void updateIntent(Ocean& ocean_ref) {
+        using Clock = TickProfiler::Clock;
+        const bool profiling = profilingTick();
+        Clock::time_point mark;
+        if (profiling) {
+            mark = Clock::now();
+        }
+        const Ocean& view = ocean_ref;
+        plans_.clear();
+        for (int idx : active_) {
+            plans_.push_back({SplitMix64::mix(intent_seed_, tick_count_, static_cast<std::uint64_t>(idx)), idx, cells_[idx].get(), Intent{}});
+        }
+        if (profiling) {
+            const Clock::time_point collected = Clock::now();
+            tick_profile_.phase_ns[static_cast<int>(TickPhase::COLLECT)] += TickProfiler::nanosBetween(mark, collected);
+            mark = collected;
+        }
+
+        auto plan_range = [&](int task, int worker_index) {
+            const size_t begin = static_cast<size_t>(task) * PLANS_PER_TASK;
+            const size_t end = std::min(plans_.size(), begin + PLANS_PER_TASK);
+            WorkerContext& context = workers_[worker_index];
+            Clock::time_point plan_mark;
+            if (profiling) {
+                plan_mark = Clock::now();
+            }
+            for (size_t i = begin; i < end; ++i) {
+                PlannedUpdate& plan = plans_[i];
+                SplitMix64 rng(plan.priority);
+                plan.intent = plan.entity->planUpdate(view, plan.idx / cols_, plan.idx % cols_, rng);
+                if (profiling) {
+                    chargeSpecies(context, type_plane_[plan.idx], plan_mark);
                 }
             }
+        };
+        const int tasks = static_cast<int>((plans_.size() + PLANS_PER_TASK - 1) / PLANS_PER_TASK);
+        if (thread_pool_) {
+            thread_pool_->run(tasks, plan_range);
+        } else {
+            for (int task = 0; task < tasks; ++task) {
+                plan_range(task, 0);
+            }
         }
+
+        if (profiling) {
+            mark = Clock::now();
+        }
+        std::sort(plans_.begin(), plans_.end(), [](const PlannedUpdate& a, const PlannedUpdate& b) {
+            return a.priority != b.priority ? a.priority < b.priority : a.idx < b.idx;
+        });
+        if (profiling) {
+            const Clock::time_point sorted = Clock::now();
+            tick_profile_.phase_ns[static_cast<int>(TickPhase::COLLECT)] += TickProfiler::nanosBetween(mark, sorted);
+            mark = sorted;
+        }
+
+        WorkerContext& context = workers_[0];
+        for (const PlannedUpdate& plan : plans_) {
+            if (cells_[plan.idx].get() != plan.entity) {
+                continue;
+            }
+            const EntityType type = type_plane_[plan.idx];
+            context.actor_idx = plan.idx;
+            plan.entity->applyUpdate(ocean_ref, plan.idx / cols_, plan.idx % cols_, plan.intent);
+            const int actor_idx = context.actor_idx;
+            if (actor_idx >= 0) {
+                if (plan.entity->isDead()) {
+                    context.dead.push_back({actor_idx, plan.entity});
+                }
+                syncPlanes(actor_idx);
+            }
+            if (profiling) {
+                chargeSpecies(context, type, mark);
+                context.profile.updates++;
+            }
+        }
+        context.actor_idx = -1;
     }
 
-    std::vector<std::pair<int, int>> getEmptyAdjacentCellsImpl(int r_param, int c_param) const {
-        std::vector<std::pair<int, int>> emptyCells;
-        const int dr[] = {-1, -1, -1,  0, 0,  1, 1, 1};
-        const int dc[] = {-1,  0,  1, -1, 1, -1, 0, 1};
+    PopulationStats getPopulationStatsImpl() const {
+        PopulationStats stats;
+        stats.tick = tick_count_;
+        stats.algae = static_cast<int>(population_.count[static_cast<int>(EntityType::ALGAE)]);
+        stats.herbivores = static_cast<int>(population_.count[static_cast<int>(EntityType::HERBIVORE)]);
+        stats.predators = static_cast<int>(population_.count[static_cast<int>(EntityType::PREDATOR)]);
+        if (track_energy_) {
+            stats.algae_energy = population_.energy[static_cast<int>(EntityType::ALGAE)];
+            stats.herbivore_energy = population_.energy[static_cast<int>(EntityType::HERBIVORE)];
+            stats.predator_energy = population_.energy[static_cast<int>(EntityType::PREDATOR)];
+        }
+        return stats;
+    }
 
-        for (int i = 0; i < 8; ++i) {
-            int nr = r_param + dr[i];
-            int nc = c_param + dc[i];
-            if (isValidCoordinateImpl(nr, nc) && !grid_[nr][nc]) { 
-                emptyCells.push_back({nr, nc});
+    // Energy is only summed while tracking is on, so enabling it recounts
+    // from the planes once.
+    void setEnergyTrackingImpl(bool enabled) {
+        if (enabled && !track_energy_) {
+            for (long long& energy : population_.energy) {
+                energy = 0;
+            }
+            for (int idx : active_) {
+                population_.energy[static_cast<int>(type_plane_[idx])] += energy_plane_[idx];
             }
         }
-        return emptyCells;
+        track_energy_ = enabled;
     }
 
-    std::vector<std::pair<int, int>> getAdjacentCellsOfTypeImpl(int r_param, int c_param, EntityType type) const {
-        std::vector<std::pair<int, int>> cellsOfType;
-        const int dr[] = {-1, -1, -1,  0, 0,  1, 1, 1}; 
-        const int dc[] = {-1,  0,  1, -1, 1, -1, 0, 1};
+    // Entities only die during their own update, where they are queued. A
+    // queued corpse may still be eaten (and its cell reused) before the end of
+    // the tick, so the cell must still hold the same dead entity.
+    void removeDeadEntities() {
+        int removed_count = 0;
+        for (WorkerContext& context : workers_) {
+            for (const auto& dead : context.dead) {
+                const int idx = dead.first;
+                if (cells_[idx].get() != dead.second || !dead.second->isDead()) {
+                    continue;
+                }
+                EntityType dead_entity_type = type_plane_[idx];
+                EventLog::emit(EventType::DEATH, dead_entity_type, idx / cols_, idx % cols_, -1, -1, dead.second->getEnergy());
+                unregisterCell(idx);
+                cells_[idx].reset(); 
+                syncPlanes(idx);
+                LOG_RATE_LIMITED(LogLevel::INFO, DEATH_LOG_LINES_PER_SECOND, "Removed dead entity of type ", static_cast<int>(dead_entity_type), " at (", idx / cols_, ",", idx % cols_, ")");
+                removed_count++;
+            }
+            context.dead.clear();
+        }
+        if (profilingTick()) {
+            tick_profile_.deaths += static_cast<std::uint64_t>(removed_count);
+        }
+    }
+
+    // Every cell learns the target the direct search would pick from it:
+    // within the (2 * radius + 1)^2 window, the smallest squared distance,
+    // ties going to the first target in row-major order, the cell itself
+    // excluded. Two column sweeps give each cell the nearest target above and
+    // below it in its column, the only candidate a column can offer (same
+    // horizontal distance, the upper one on a tie). A row pass then takes,
+    // for each column offset, the minimum of packed keys ordered like the
+    // search: (squared distance, row offset, column offset). Costs
+    // O(rows * cols * radius) in branch-free sequential loops, whatever the
+    // number of targets.
+    static constexpr int FLOW_KEY_BITS = 6; // offsets + radius fit, radius <= 31
+    static constexpr int FLOW_KEY_NONE = 1 << 30;
+
+    static int flowKey(int dist_sq, int dr, int dc, int radius) {
+        return (((dist_sq << FLOW_KEY_BITS) | (dr + radius)) << FLOW_KEY_BITS) | (dc + radius);
+    }
+
+    void buildFlowField(FlowField& field) {
+        // Locals, so that stores through the int buffers below cannot alias them.
+        const int rows = rows_;
+        const int cols = cols_;
+        const size_t area = static_cast<size_t>(rows) * static_cast<size_t>(cols);
+        if (field.stamp.size() != area) {
+            field.stamp.assign(area, 0);
+            field.nearest.assign(area, -1);
+            field.dist_sq.assign(area, 0);
+            field.below.assign(area, -1);
+            field.generation = 0;
+        }
+        if (++field.generation == 0) {
+            std::fill(field.stamp.begin(), field.stamp.end(), 0);
+            field.generation = 1;
+        }
+        const EntityType target = field.target;
+        const int radius = field.radius;
+
+        // Bottom-up: column_above temporarily holds the last target row seen below.
+        field.column_above.assign(cols, -1);
+        int* column_above = field.column_above.data();
+        for (int r = rows - 1; r >= 0; --r) {
+            const EntityType* types = &type_plane_[static_cast<size_t>(r) * cols];
+            int* below = &field.below[static_cast<size_t>(r) * cols];
+            for (int c = 0; c < cols; ++c) {
+                const int next = column_above[c];
+                below[c] = (next >= 0 && next - r <= radius) ? next : -1;
+                column_above[c] = types[c] == target ? r : next;
+            }
+        }
+
+        // Column keys carry no column offset and are padded by `radius`
+        // sentinels on both sides, so the row pass needs no bounds checks.
+        std::fill(field.column_above.begin(), field.column_above.end(), -1);
+        field.inclusive_key.assign(static_cast<size_t>(cols) + 2 * radius, FLOW_KEY_NONE);
+        field.best_key.resize(cols);
+        int* inclusive = field.inclusive_key.data() + radius;
+        int* best_key = field.best_key.data();
+        const std::uint32_t generation = field.generation;
+        for (int r = 0; r < rows; ++r) {
+            const size_t row_start = static_cast<size_t>(r) * cols;
+            const EntityType* types = &type_plane_[row_start];
+            const int* below_row = &field.below[row_start];
+            std::uint32_t* stamp = &field.stamp[row_start];
+            int* nearest = &field.nearest[row_start];
+            int* dist_sq = &field.dist_sq[row_start];
+            // column_above still holds the rows above r when c is reached.
+            for (int c = 0; c < cols; ++c) {
+                const int above = column_above[c];
+                const int below = below_row[c];
+                const int up = (above >= 0 && r - above <= radius) ? above : -1;
+                const int best = (below >= 0 && (up < 0 || below - r < r - up)) ? below : up;
+                const int strict = best < 0 ? FLOW_KEY_NONE : flowKey((best - r) * (best - r), best - r, 0, radius) - radius;
+                const bool is_target = types[c] == target;
+                best_key[c] = strict + radius;
+                inclusive[c] = is_target ? flowKey(0, 0, 0, radius) - radius : strict;
+                column_above[c] = is_target ? r : above;
+            }
+            for (int dc = -radius; dc <= radius; ++dc) {
+                if (dc == 0) {
+                    continue;
+                }
+                const int add = flowKey(dc * dc, 0, dc, radius) - (radius << FLOW_KEY_BITS);
+                const int* column = inclusive + dc;
+                for (int c = 0; c < cols; ++c) {
+                    best_key[c] = std::min(best_key[c], column[c] + add);
+                }
+            }
+            // Cells with no target in their window get stamp 0, which no
+            // generation uses; their other entries are never read.
+            const int mask = (1 << FLOW_KEY_BITS) - 1;
+            for (int c = 0; c < cols; ++c) {
+                const int key = best_key[c];
+                const int dc = (key & mask) - radius;
+                const int dr = ((key >> FLOW_KEY_BITS) & mask) - radius;
+                stamp[c] = key < FLOW_KEY_NONE ? generation : 0;
+                nearest[c] = static_cast<int>(row_start) + c + dr * cols + dc;
+                dist_sq[c] = key >> (2 * FLOW_KEY_BITS);
+            }
+        }
+        field.active = true;
+    }
+
+    // In AUTO mode a field is built when the hungry seekers would otherwise
+    // scan more cells than the build is worth. Per-fish scans stop at the
+    // first hit, so they are assumed to cover half their window; measured
+    // on 1024x1024 grids, building a field costs about as much per grid cell
+    // as scanning FLOW_FIELD_BUILD_CELL_COST cells of a sight window.
+    static constexpr long long FLOW_FIELD_BUILD_CELL_COST = 12;
+
+    void prepareFlowFields() {
+        if (flow_field_mode_ == FlowFieldMode::OFF) {
+            return;
+        }
+        long long seekers[FLOW_FIELD_COUNT] = {0, 0};
+        for (int idx : active_) {
+            switch (type_plane_[idx]) {
+                case EntityType::HERBIVORE:
+                    if (HerbivoreFish::isSeekingFood(energy_plane_[idx] - Config::HERBIVORE_ENERGY_PER_TICK)) {
+                        seekers[0]++;
+                    }
+                    break;
+                case EntityType::PREDATOR:
+                    if (PredatorFish::isHunting(energy_plane_[idx] - Config::PREDATOR_ENERGY_PER_TICK)) {
+                        seekers[1]++;
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        const long long area = static_cast<long long>(rows_) * cols_;
+        for (int f = 0; f < FLOW_FIELD_COUNT; ++f) {
+            FlowField& field = flow_fields_[f];
+            const long long window = static_cast<long long>(2 * field.radius + 1) * (2 * field.radius + 1);
+            const long long field_cost = area * FLOW_FIELD_BUILD_CELL_COST;
+            const long long scan_cost = seekers[f] * window / 2;
+            if (flow_field_mode_ == FlowFieldMode::ALWAYS || (seekers[f] > 0 && scan_cost > field_cost)) {
+                buildFlowField(field);
+            }
+        }
+        flow_fields_current_.store(true, std::memory_order_relaxed);
+    }
+
+    const FlowField* activeFlowField(EntityType target_type, int radius) const {
+        for (const FlowField& field : flow_fields_) {
+            if (field.active && field.target == target_type && field.radius == radius) {
+                return &field;
+            }
+        }
+        return nullptr;
+    }
+
+    void beginTickProfile() {
+        tick_profile_ = TickProfile{};
+        tick_profile_.tick = tick_count_;
+        for (WorkerContext& context : workers_) {
+            context.profile = TickProfile{};
+        }
+        profile_tick_ = true;
+    }
+
+    // Shuffles done inside runUpdates count as COLLECT in a serial tick; in a
+    // parallel tick they run inside the tile tasks and stay in UPDATE.
+    void finishTickProfile(TickProfiler::Clock::time_point start, TickProfiler::Clock::time_point flow_done,
+                           TickProfiler::Clock::time_point update_done, bool parallel) {
+        const TickProfiler::Clock::time_point end = TickProfiler::Clock::now();
+        profile_tick_ = false;
+        TickProfile& total = tick_profile_;
+        for (WorkerContext& context : workers_) {
+            const TickProfile& part = context.profile;
+            for (int s = 0; s < PROFILED_SPECIES_COUNT; ++s) {
+                total.species_ns[s] += part.species_ns[s];
+            }
+            total.updates += part.updates;
+            total.moves += part.moves;
+            total.eats += part.eats;
+            total.births += part.births;
+        }
+        std::uint64_t* phase = total.phase_ns;
+        const int collect = static_cast<int>(TickPhase::COLLECT);
+        if (!parallel) {
+            phase[collect] += workers_[0].profile.phase_ns[collect];
+        }
+        const std::uint64_t update_section = TickProfiler::nanosBetween(flow_done, update_done);
+        phase[static_cast<int>(TickPhase::FLOW_FIELDS)] = TickProfiler::nanosBetween(start, flow_done);
+        phase[static_cast<int>(TickPhase::UPDATE)] = update_section - std::min(update_section, phase[collect]);
+        phase[static_cast<int>(TickPhase::SWEEP)] = TickProfiler::nanosBetween(update_done, end);
+        phase[static_cast<int>(TickPhase::TOTAL)] = TickProfiler::nanosBetween(start, end);
+        profiler_.record(total);
+    }
+
+    void tickImpl(Ocean& ocean_ref) {
+        using Clock = TickProfiler::Clock;
+        const bool profiling = TickProfiler::COMPILED && profiling_;
+        const bool parallel = update_mode_ != UpdateMode::INTENT && thread_pool_;
+        Clock::time_point start, flow_done, update_done;
+        if (profiling) {
+            beginTickProfile();
+            start = Clock::now();
+        }
+        EventLog::setTick(static_cast<std::uint32_t>(tick_count_));
+        prepareFlowFields();
+        if (profiling) {
+            flow_done = Clock::now();
+        }
+        if (update_mode_ == UpdateMode::INTENT) {
+            updateIntent(ocean_ref);
+        } else if (parallel) {
+            updateParallel(ocean_ref);
+        } else {
+            updateSerial(ocean_ref);
+        }
+        if (profiling) {
+            update_done = Clock::now();
+        }
+        for (FlowField& field : flow_fields_) {
+            field.active = false;
+        }
+        removeDeadEntities();
+        if (profiling) {
+            finishTickProfile(start, flow_done, update_done, parallel);
+        }
+        Logger::endTick();
+        ++tick_count_;
+        population_history_.push(getPopulationStatsImpl());
+    }
+
+    // Neighbor order shared by all adjacency queries: row-major around (r, c).
+    static constexpr int NEIGHBOR_DR[8] = {-1, -1, -1,  0, 0,  1, 1, 1};
+    static constexpr int NEIGHBOR_DC[8] = {-1,  0,  1, -1, 1, -1, 0, 1};
 
+    void getAdjacentCellsOfTypeImpl(int r_param, int c_param, EntityType type, NeighborList& out) const {
+        out.clear();
         for (int i = 0; i < 8; ++i) {
-            int nr = r_param + dr[i];
-            int nc = c_param + dc[i];
-            if (isValidCoordinateImpl(nr, nc) && grid_[nr][nc] && grid_[nr][nc]->getType() == type) {
-                cellsOfType.push_back({nr, nc});
+            int nr = r_param + NEIGHBOR_DR[i];
+            int nc = c_param + NEIGHBOR_DC[i];
+            if (isValidCoordinateImpl(nr, nc) && type_plane_[indexOf(nr, nc)] == type) {
+                out.push_back({nr, nc});
             }
         }
-        return cellsOfType;
+    }
+
+    void getEmptyAdjacentCellsImpl(int r_param, int c_param, NeighborList& out) const {
+        getAdjacentCellsOfTypeImpl(r_param, c_param, EntityType::SAND, out);
+    }
+
+    std::vector<std::pair<int, int>> getEmptyAdjacentCellsImpl(int r_param, int c_param) const {
+        NeighborList emptyCells;
+        getEmptyAdjacentCellsImpl(r_param, c_param, emptyCells);
+        return std::vector<std::pair<int, int>>(emptyCells.begin(), emptyCells.end());
+    }
+
+    std::vector<std::pair<int, int>> getAdjacentCellsOfTypeImpl(int r_param, int c_param, EntityType type) const {
+        if (type == EntityType::SAND) {
+            return {};
+        }
+        NeighborList cellsOfType;
+        getAdjacentCellsOfTypeImpl(r_param, c_param, type, cellsOfType);
+        return std::vector<std::pair<int, int>>(cellsOfType.begin(), cellsOfType.end());
+    }
+
+    struct SightOffset {
+        int dr;
+        int dc;
+    };
+
+    static constexpr int MAX_TABLE_SIGHT_RADIUS = 16;
+
+    // Offsets of the (2r+1)^2 window minus the center, ordered by squared
+    // distance and then row-major. The first matching cell in this order is
+    // exactly the one the full square scan (row-major, strict <) picks.
+    static const std::vector<SightOffset>& sightOffsets(int radius) {
+        static const std::vector<std::vector<SightOffset>> tables = [] {
+            std::vector<std::vector<SightOffset>> built(MAX_TABLE_SIGHT_RADIUS + 1);
+            for (int rad = 0; rad <= MAX_TABLE_SIGHT_RADIUS; ++rad) {
+                for (int dr = -rad; dr <= rad; ++dr) {
+                    for (int dc = -rad; dc <= rad; ++dc) {
+                        if (dr != 0 || dc != 0) {
+                            built[rad].push_back({dr, dc});
+                        }
+                    }
+                }
+                std::stable_sort(built[rad].begin(), built[rad].end(), [](const SightOffset& a, const SightOffset& b) {
+                    return a.dr * a.dr + a.dc * a.dc < b.dr * b.dr + b.dc * b.dc;
+                });
+            }
+            return built;
+        }();
+        return tables[radius];
+    }
+
+    static std::pair<int, int> directionTowards(int start_r, int start_c, int target_r, int target_c) {
+        int move_dr = 0;
+        if (target_r < start_r) move_dr = -1;
+        else if (target_r > start_r) move_dr = 1;
+
+        int move_dc = 0;
+        if (target_c < start_c) move_dc = -1;
+        else if (target_c > start_c) move_dc = 1;
+
+        return {move_dr, move_dc};
     }
 
     std::pair<int, int> getDirectionToNearestTargetImpl(int start_r, int start_c, EntityType target_type, int radius) const {
+        if (target_type == EntityType::SAND || radius <= 0 || !isValidCoordinateImpl(start_r, start_c)) {
+            return {0, 0};
+        }
+        if (const FlowField* field = activeFlowField(target_type, radius)) {
+            // The field is a snapshot from the start of the tick. Once the
+            // grid has changed, a cell with no target in its window, or whose
+            // target has since been eaten, falls back to the direct search,
+            // which also sees targets added this tick.
+            const int idx = indexOf(start_r, start_c);
+            if (field->stamp[idx] == field->generation) {
+                const int target = field->nearest[idx];
+                if (type_plane_[target] == target_type) {
+                    return directionTowards(start_r, start_c, target / cols_, target % cols_);
+                }
+            } else if (flow_fields_current_.load(std::memory_order_relaxed)) {
+                return {0, 0};
+            }
+        }
+        if (radius > MAX_TABLE_SIGHT_RADIUS) {
+            return scanNearestTarget(start_r, start_c, target_type, radius);
+        }
+
+        const bool window_inside = start_r - radius >= 0 && start_r + radius < rows_ &&
+                                   start_c - radius >= 0 && start_c + radius < cols_;
+        const EntityType* center = &type_plane_[indexOf(start_r, start_c)];
+        for (const SightOffset& offset : sightOffsets(radius)) {
+            if (!window_inside && !isValidCoordinateImpl(start_r + offset.dr, start_c + offset.dc)) {
+                continue;
+            }
+            if (center[offset.dr * cols_ + offset.dc] == target_type) {
+                return directionTowards(start_r, start_c, start_r + offset.dr, start_c + offset.dc);
+            }
+        }
+        return {0, 0};
+    }
+
+    // Full window scan, used for radii beyond the precomputed tables.
+    std::pair<int, int> scanNearestTarget(int start_r, int start_c, EntityType target_type, int radius) const {
         std::pair<int, int> best_target_pos = {-1, -1};
         int min_dist_sq = (radius * radius) * 2 + 1; 
 
-        for (int r_check = start_r - radius; r_check <= start_r + radius; ++r_check) {
-            for (int c_check = start_c - radius; c_check <= start_c + radius; ++c_check) {
+        const int r_begin = std::max(start_r - radius, 0);
+        const int r_end = std::min(start_r + radius, rows_ - 1);
+        const int c_begin = std::max(start_c - radius, 0);
+        const int c_end = std::min(start_c + radius, cols_ - 1);
+
+        for (int r_check = r_begin; r_check <= r_end; ++r_check) {
+            const EntityType* row = &type_plane_[indexOf(r_check, 0)];
+            for (int c_check = c_begin; c_check <= c_end; ++c_check) {
                 if (r_check == start_r && c_check == start_c) continue;
 
-                if (isValidCoordinateImpl(r_check, c_check)) {
-                    Entity* entity_ptr = grid_[r_check][c_check].get();
-                    if (entity_ptr && entity_ptr->getType() == target_type) {
-                        int dr_dist = r_check - start_r;
-                        int dc_dist = c_check - start_c;
-                        int dist_sq = dr_dist * dr_dist + dc_dist * dc_dist; 
+                if (row[c_check] == target_type) {
+                    int dr_dist = r_check - start_r;
+                    int dc_dist = c_check - start_c;
+                    int dist_sq = dr_dist * dr_dist + dc_dist * dc_dist; 
 
-                        if (dist_sq < min_dist_sq) {
-                            min_dist_sq = dist_sq;
-                            best_target_pos = {r_check, c_check};
-                        }
+                    if (dist_sq < min_dist_sq) {
+                        min_dist_sq = dist_sq;
+                        best_target_pos = {r_check, c_check};
                     }
                 }
             }
         }
 
         if (best_target_pos.first != -1) { 
-            int move_dr = 0;
-            if (best_target_pos.first < start_r) move_dr = -1;
-            else if (best_target_pos.first > start_r) move_dr = 1;
-
-            int move_dc = 0;
-            if (best_target_pos.second < start_c) move_dc = -1;
-            else if (best_target_pos.second > start_c) move_dc = 1;
-            
-            return {move_dr, move_dc};
+            return directionTowards(start_r, start_c, best_target_pos.first, best_target_pos.second);
         }
         return {0, 0}; 
     }
@@ -229,7 +1234,7 @@ Ocean::~Ocean() = default;
 Ocean::Ocean(Ocean&& other) noexcept = default;
 Ocean& Ocean::operator=(Ocean&& other) noexcept = default;
 
-bool Ocean::addEntity(std::unique_ptr<Entity> entity, int r, int c) {
+bool Ocean::addEntity(EntityPtr entity, int r, int c) {
     if (!pImpl_) { 
         std::string err_msg = "Ocean::addEntity called on an invalid (moved-from or uninitialized) Ocean object.";
         Logger::error(err_msg);
@@ -247,7 +1252,7 @@ Entity* Ocean::getEntity(int r, int c) const {
     return pImpl_->getEntityImpl(r, c);
 }
 
-std::unique_ptr<Entity> Ocean::removeEntity(int r, int c) {
+EntityPtr Ocean::removeEntity(int r, int c) {
     if (!pImpl_) { 
         std::string err_msg = "Ocean::removeEntity called on an invalid (moved-from or uninitialized) Ocean object.";
         Logger::error(err_msg);
@@ -328,6 +1333,28 @@ std::vector<std::pair<int, int>> Ocean::getAdjacentCellsOfType(int r, int c, Ent
     return pImpl_->getAdjacentCellsOfTypeImpl(r, c, type);
 }
 
+void Ocean::getEmptyAdjacentCells(int r, int c, NeighborList& out) const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getEmptyAdjacentCells called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->getEmptyAdjacentCellsImpl(r, c, out);
+}
+
+void Ocean::getAdjacentCellsOfType(int r, int c, EntityType type, NeighborList& out) const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getAdjacentCellsOfType called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    if (type == EntityType::SAND) {
+        out.clear();
+        return;
+    }
+    pImpl_->getAdjacentCellsOfTypeImpl(r, c, type, out);
+}
+
 std::pair<int, int> Ocean::getDirectionToNearestTarget(int start_r, int start_c, EntityType target_type, int radius) const {
     if (!pImpl_) { 
         std::string err_msg = "Ocean::getDirectionToNearestTarget called on an invalid (moved-from or uninitialized) Ocean object.";
@@ -335,4 +1362,314 @@ std::pair<int, int> Ocean::getDirectionToNearestTarget(int start_r, int start_c,
         throw std::runtime_error(err_msg);
     }
     return pImpl_->getDirectionToNearestTargetImpl(start_r, start_c, target_type, radius);
+}
+
+void Ocean::setDispatchMode(DispatchMode mode) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::setDispatchMode called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->dispatch_mode_ = mode;
+}
+
+DispatchMode Ocean::getDispatchMode() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getDispatchMode called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->dispatch_mode_;
+}
+
+void Ocean::setFlowFieldMode(FlowFieldMode mode) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::setFlowFieldMode called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->flow_field_mode_ = mode;
+}
+
+FlowFieldMode Ocean::getFlowFieldMode() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getFlowFieldMode called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->flow_field_mode_;
+}
+
+void Ocean::setThreadCount(int thread_count) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::setThreadCount called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->setThreadCountImpl(thread_count);
+}
+
+int Ocean::getThreadCount() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getThreadCount called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return static_cast<int>(pImpl_->workers_.size());
+}
+
+void Ocean::setTileSize(int tile_size) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::setTileSize called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->tile_size_ = std::max(tile_size, OceanImpl::MIN_TILE_SIZE);
+}
+
+int Ocean::getTileSize() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getTileSize called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->tile_size_;
+}
+
+void Ocean::setUpdateMode(UpdateMode mode) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::setUpdateMode called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->update_mode_ = mode;
+}
+
+UpdateMode Ocean::getUpdateMode() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getUpdateMode called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->update_mode_;
+}
+
+void Ocean::setIntentSeed(std::uint64_t seed) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::setIntentSeed called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->intent_seed_ = seed;
+}
+
+unsigned long long Ocean::getTickCount() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getTickCount called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->tick_count_;
+}
+
+PopulationStats Ocean::getPopulationStats() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getPopulationStats called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->getPopulationStatsImpl();
+}
+
+int Ocean::getPopulation(EntityType type) const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getPopulation called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return static_cast<int>(pImpl_->population_.count[static_cast<int>(type)]);
+}
+
+void Ocean::setEnergyTracking(bool enabled) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::setEnergyTracking called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->setEnergyTrackingImpl(enabled);
+}
+
+bool Ocean::isEnergyTracking() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::isEnergyTracking called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->track_energy_;
+}
+
+long long Ocean::getTotalEnergy(EntityType type) const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getTotalEnergy called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->track_energy_ ? pImpl_->population_.energy[static_cast<int>(type)] : 0;
+}
+
+void Ocean::setPopulationHistory(size_t ticks) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::setPopulationHistory called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->population_history_.setCapacity(ticks);
+}
+
+std::vector<PopulationStats> Ocean::getPopulationHistory() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getPopulationHistory called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->population_history_.toVector();
+}
+
+const std::vector<std::uint8_t>& Ocean::getRenderStates() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getRenderStates called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->render_plane_;
+}
+
+void Ocean::setDirtyTracking(bool enabled) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::setDirtyTracking called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->setDirtyTrackingImpl(enabled);
+}
+
+bool Ocean::isDirtyTracking() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::isDirtyTracking called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->track_dirty_;
+}
+
+const std::vector<int>& Ocean::getDirtyCells() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getDirtyCells called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->dirty_cells_;
+}
+
+void Ocean::clearDirtyCells() {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::clearDirtyCells called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->clearDirtyCellsImpl();
+}
+
+void Ocean::setProfilingEnabled(bool enabled) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::setProfilingEnabled called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    if (enabled && !TickProfiler::COMPILED) {
+        Logger::warn("Tick profiling requested, but this build has OCEAN_ENABLE_PROFILER off.");
+        return;
+    }
+    pImpl_->profiling_ = enabled;
+}
+
+bool Ocean::isProfilingEnabled() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::isProfilingEnabled called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return TickProfiler::COMPILED && pImpl_->profiling_;
+}
+
+void Ocean::setProfileWindow(size_t ticks) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::setProfileWindow called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->profiler_.setWindow(ticks);
+}
+
+void Ocean::clearTickProfiles() {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::clearTickProfiles called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->profiler_.clear();
+}
+
+TickProfile Ocean::getLastTickProfile() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getLastTickProfile called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->profiler_.last();
+}
+
+std::vector<TickProfile> Ocean::getTickProfiles() const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getTickProfiles called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->profiler_.history();
+}
+
+void Ocean::dumpTickProfile(std::ostream& out) const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::dumpTickProfile called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->profiler_.dump(out);
+}
+
+PoolStats Ocean::getPoolStats(EntityType type) const {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getPoolStats called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->pool_.getStats(type);
+}
+
+void Ocean::reservePool(EntityType type, size_t slots) {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::reservePool called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    pImpl_->pool_.reserve(type, slots);
+}
+
+EntityPool& Ocean::getPool() {
+    if (!pImpl_) { 
+        std::string err_msg = "Ocean::getPool called on an invalid (moved-from or uninitialized) Ocean object.";
+        Logger::error(err_msg);
+        throw std::runtime_error(err_msg);
+    }
+    return pImpl_->pool_;
 }
\ No newline at end of file
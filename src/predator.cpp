@@ -2,6 +2,7 @@
 #include "ocean.hpp"
 #include "herbivore.hpp" 
 #include "utils/logger.hpp"
+#include "utils/event_log.hpp"
 #include <vector>
 #include <utility>
 
@@ -13,23 +14,44 @@ PredatorFish::PredatorFish(int initial_energy)
 }
 
 bool PredatorFish::isDead() const {
-    return energy_ <= 0 || age_ >= Config::PREDATOR_MAX_AGE;
+    return isDying(energy_, age_);
+}
+
+bool PredatorFish::isDying(int energy, int age) {
+    return energy <= 0 || age >= Config::PREDATOR_MAX_AGE;
+}
+
+bool PredatorFish::isStarving(int energy) {
+    return energy < Config::PREDATOR_CRITICAL_ENERGY_THRESHOLD / 2;
+}
+
+bool PredatorFish::isHunting(int energy) {
+    return energy < Config::PREDATOR_CRITICAL_ENERGY_THRESHOLD * 1.5;
+}
+
+int PredatorFish::getEnergy() const {
+    return energy_;
+}
+
+int PredatorFish::getAge() const {
+    return age_;
 }
 
 bool PredatorFish::tryToEat(Ocean& ocean, int current_r, int current_c) {
-    std::vector<std::pair<int, int>> herbivoreNeighbors = ocean.getAdjacentCellsOfType(current_r, current_c, EntityType::HERBIVORE);
+    NeighborList herbivoreNeighbors;
+    ocean.getAdjacentCellsOfType(current_r, current_c, EntityType::HERBIVORE, herbivoreNeighbors);
 
     if (!herbivoreNeighbors.empty()) {
-        Random::shuffle(herbivoreNeighbors);
-        std::pair<int, int> herbivorePos = herbivoreNeighbors[0];
+        std::pair<int, int> herbivorePos = Random::pick(herbivoreNeighbors);
 
-        std::unique_ptr<Entity> eatenHerbivore = ocean.removeEntity(herbivorePos.first, herbivorePos.second);
+        EntityPtr eatenHerbivore = ocean.removeEntity(herbivorePos.first, herbivorePos.second);
         if (eatenHerbivore && eatenHerbivore->getType() == EntityType::HERBIVORE) { 
             energy_ += Config::PREDATOR_ENERGY_FROM_HERBIVORE;
             if (energy_ > Config::PREDATOR_MAX_ENERGY) {
                 energy_ = Config::PREDATOR_MAX_ENERGY;
             }
             ocean.moveEntity(current_r, current_c, herbivorePos.first, herbivorePos.second);
+            EventLog::emit(EventType::EAT, EntityType::PREDATOR, current_r, current_c, herbivorePos.first, herbivorePos.second, energy_);
             Logger::info("P at (", herbivorePos.first, ",", herbivorePos.second, 
                           ") ate Herbivore. E:", energy_);
             return true;
@@ -45,15 +67,16 @@ bool PredatorFish::tryToReproduce(Ocean& ocean, int current_r, int current_c) {
     if (energy_ >= Config::PREDATOR_REPRODUCTION_ENERGY_THRESHOLD &&
         Random::getInt(1, 100) <= Config::PREDATOR_REPRODUCTION_CHANCE_PERCENT) {
         
-        std::vector<std::pair<int, int>> emptyNeighbors = ocean.getEmptyAdjacentCells(current_r, current_c);
+        NeighborList emptyNeighbors;
+        ocean.getEmptyAdjacentCells(current_r, current_c, emptyNeighbors);
         if (!emptyNeighbors.empty()) {
-            Random::shuffle(emptyNeighbors);
-            std::pair<int, int> offspringPos = emptyNeighbors[0];
+            std::pair<int, int> offspringPos = Random::pick(emptyNeighbors);
 
-            auto offspring = std::make_unique<PredatorFish>(Config::PREDATOR_OFFSPRING_INITIAL_ENERGY);
+            auto offspring = ocean.createEntity<PredatorFish>(Config::PREDATOR_OFFSPRING_INITIAL_ENERGY);
             
             if (ocean.addEntity(std::move(offspring), offspringPos.first, offspringPos.second)) {
                 energy_ -= Config::PREDATOR_REPRODUCTION_COST;
+                EventLog::emit(EventType::BIRTH, EntityType::PREDATOR, current_r, current_c, offspringPos.first, offspringPos.second, energy_);
                 Logger::info("P at (", current_r, ",", current_c, ") reproduced to (", 
                            offspringPos.first, ",", offspringPos.second, "). Parent E:", energy_);
                 return true;
@@ -64,7 +87,7 @@ bool PredatorFish::tryToReproduce(Ocean& ocean, int current_r, int current_c) {
 }
 
 void PredatorFish::huntOrExplore(Ocean& ocean, int current_r, int current_c) {
-    bool actively_hunting = (energy_ < Config::PREDATOR_CRITICAL_ENERGY_THRESHOLD * 1.5);
+    bool actively_hunting = isHunting(energy_);
 
     if (actively_hunting) {
         std::pair<int, int> direction = ocean.getDirectionToNearestTarget(current_r, current_c, EntityType::HERBIVORE, Config::PREDATOR_SIGHT_RADIUS);
@@ -77,7 +100,9 @@ void PredatorFish::huntOrExplore(Ocean& ocean, int current_r, int current_c) {
                 Entity* entity_at_target_step = ocean.getEntity(next_r, next_c);
                 if (!entity_at_target_step || entity_at_target_step->getType() == EntityType::HERBIVORE) {
                     Logger::debug("P @(", current_r, ",", current_c, ") moving towards prey to (", next_r, ",", next_c, ")");
-                    ocean.moveEntity(current_r, current_c, next_r, next_c);
+                    if (ocean.moveEntity(current_r, current_c, next_r, next_c)) {
+                        EventLog::emit(EventType::MOVE, EntityType::PREDATOR, current_r, current_c, next_r, next_c, energy_);
+                    }
                     return; 
                 }
             }
@@ -85,12 +110,14 @@ void PredatorFish::huntOrExplore(Ocean& ocean, int current_r, int current_c) {
     }
 
     Logger::debug("P @(", current_r, ",", current_c, ") exploring randomly.");
-    std::vector<std::pair<int, int>> emptyNeighbors = ocean.getEmptyAdjacentCells(current_r, current_c);
+    NeighborList emptyNeighbors;
+    ocean.getEmptyAdjacentCells(current_r, current_c, emptyNeighbors);
     if (!emptyNeighbors.empty()) {
-        Random::shuffle(emptyNeighbors); 
-        std::pair<int, int> targetCell = emptyNeighbors[0];
+        std::pair<int, int> targetCell = Random::pick(emptyNeighbors);
         Logger::debug("P @(", current_r, ",", current_c, ") random move to (", targetCell.first, ",", targetCell.second,")");
-        ocean.moveEntity(current_r, current_c, targetCell.first, targetCell.second);
+        if (ocean.moveEntity(current_r, current_c, targetCell.first, targetCell.second)) {
+            EventLog::emit(EventType::MOVE, EntityType::PREDATOR, current_r, current_c, targetCell.first, targetCell.second, energy_);
+        }
     } else {
         Logger::debug("P @(", current_r, ",", current_c, ") has nowhere to move (exploring).");
     }
@@ -126,9 +153,107 @@ void PredatorFish::update(Ocean& ocean, int r, int c) {
     Logger::debug("P @(", r, ",", c, ") finished huntOrExplore. Update finished.");
 }
 
+std::pair<int, int> PredatorFish::planMove(const Ocean& ocean, int current_r, int current_c, int energy,
+                                           std::pair<int, int> reserved, SplitMix64& rng) const {
+    if (isHunting(energy)) {
+        std::pair<int, int> direction = ocean.getDirectionToNearestTarget(current_r, current_c, EntityType::HERBIVORE, Config::PREDATOR_SIGHT_RADIUS);
+        if (direction.first != 0 || direction.second != 0) {
+            std::pair<int, int> next = {current_r + direction.first, current_c + direction.second};
+            if (next != reserved && ocean.isValidCoordinate(next.first, next.second)) {
+                const Entity* entity_at_target_step = ocean.getEntity(next.first, next.second);
+                if (!entity_at_target_step || entity_at_target_step->getType() == EntityType::HERBIVORE) {
+                    return next;
+                }
+            }
+        }
+    }
+
+    NeighborList emptyNeighbors;
+    ocean.getEmptyAdjacentCells(current_r, current_c, emptyNeighbors);
+    NeighborList candidates;
+    for (const auto& cell : emptyNeighbors) {
+        if (cell != reserved) {
+            candidates.push_back(cell);
+        }
+    }
+    if (candidates.empty()) {
+        return {-1, -1};
+    }
+    return candidates[rng.nextInt(0, candidates.size() - 1)];
+}
+
+// Mirrors update(): starve/age, eat an adjacent herbivore, maybe reproduce, then hunt or explore.
+Intent PredatorFish::planUpdate(const Ocean& ocean, int r, int c, SplitMix64& rng) const {
+    Intent intent;
+    int energy = energy_ - Config::PREDATOR_ENERGY_PER_TICK;
+    if (energy <= 0 || age_ + 1 >= Config::PREDATOR_MAX_AGE) {
+        return intent;
+    }
+
+    NeighborList herbivoreNeighbors;
+    ocean.getAdjacentCellsOfType(r, c, EntityType::HERBIVORE, herbivoreNeighbors);
+    if (!herbivoreNeighbors.empty()) {
+        intent.eat = herbivoreNeighbors[rng.nextInt(0, herbivoreNeighbors.size() - 1)];
+        return intent;
+    }
+
+    if (energy > Config::PREDATOR_CRITICAL_ENERGY_THRESHOLD * 1.2 &&
+        energy >= Config::PREDATOR_REPRODUCTION_ENERGY_THRESHOLD &&
+        rng.nextInt(1, 100) <= Config::PREDATOR_REPRODUCTION_CHANCE_PERCENT) {
+        NeighborList emptyNeighbors;
+        ocean.getEmptyAdjacentCells(r, c, emptyNeighbors);
+        if (!emptyNeighbors.empty()) {
+            intent.spawn = emptyNeighbors[rng.nextInt(0, emptyNeighbors.size() - 1)];
+            energy -= Config::PREDATOR_REPRODUCTION_COST;
+        }
+    }
+
+    intent.move = planMove(ocean, r, c, energy, intent.spawn, rng);
+    return intent;
+}
+
+void PredatorFish::applyUpdate(Ocean& ocean, int r, int c, const Intent& intent) {
+    age_++;
+    energy_ -= Config::PREDATOR_ENERGY_PER_TICK;
+    if (isDead()) {
+        return;
+    }
+
+    if (intent.eat.first >= 0) {
+        Entity* target = ocean.getEntity(intent.eat.first, intent.eat.second);
+        if (target && target->getType() == EntityType::HERBIVORE) {
+            ocean.removeEntity(intent.eat.first, intent.eat.second);
+            energy_ += Config::PREDATOR_ENERGY_FROM_HERBIVORE;
+            if (energy_ > Config::PREDATOR_MAX_ENERGY) {
+                energy_ = Config::PREDATOR_MAX_ENERGY;
+            }
+            ocean.moveEntity(r, c, intent.eat.first, intent.eat.second);
+            EventLog::emit(EventType::EAT, EntityType::PREDATOR, r, c, intent.eat.first, intent.eat.second, energy_);
+            Logger::info("P at (", intent.eat.first, ",", intent.eat.second, 
+                          ") ate Herbivore. E:", energy_);
+        }
+        return;
+    }
+
+    if (intent.spawn.first >= 0 &&
+        ocean.addEntity(ocean.createEntity<PredatorFish>(Config::PREDATOR_OFFSPRING_INITIAL_ENERGY), intent.spawn.first, intent.spawn.second)) {
+        energy_ -= Config::PREDATOR_REPRODUCTION_COST;
+        EventLog::emit(EventType::BIRTH, EntityType::PREDATOR, r, c, intent.spawn.first, intent.spawn.second, energy_);
+        Logger::info("P at (", r, ",", c, ") reproduced to (", 
+                   intent.spawn.first, ",", intent.spawn.second, "). Parent E:", energy_);
+        if (isDead()) {
+            return;
+        }
+    }
+
+    if (intent.move.first >= 0 && ocean.moveEntity(r, c, intent.move.first, intent.move.second)) {
+        EventLog::emit(EventType::MOVE, EntityType::PREDATOR, r, c, intent.move.first, intent.move.second, energy_);
+    }
+}
+
 char PredatorFish::getSymbol() const {
     if (isDead()) return 'x';
-    if (energy_ < Config::PREDATOR_CRITICAL_ENERGY_THRESHOLD / 2) return 'p';
+    if (isStarving(energy_)) return 'p';
     return 'P';
 }
 
@@ -0,0 +1,88 @@
+#include "utils/event_log.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+#include "utils/logger.hpp"
+
+namespace {
+
+constexpr std::size_t EVENT_BUFFER_RECORDS = 4096;
+
+std::mutex event_file_mutex;
+std::ofstream event_file_stream;
+
+void writeRecords(std::vector<EventRecord>& records) {
+    if (records.empty()) {
+        return;
+    }
+    if (event_file_stream.is_open()) {
+        event_file_stream.write(reinterpret_cast<const char*>(records.data()),
+                                static_cast<std::streamsize>(records.size() * sizeof(EventRecord)));
+    }
+    records.clear();
+}
+
+// Per-thread batch of records. Buffers register themselves so close() can
+// drain threads that are still alive; a thread that exits first drains its
+// own buffer on the way out.
+struct EventBuffer;
+std::vector<EventBuffer*> event_buffers;
+
+struct EventBuffer {
+    std::vector<EventRecord> records;
+
+    EventBuffer() {
+        records.reserve(EVENT_BUFFER_RECORDS);
+        std::lock_guard<std::mutex> lock(event_file_mutex);
+        event_buffers.push_back(this);
+    }
+
+    ~EventBuffer() {
+        std::lock_guard<std::mutex> lock(event_file_mutex);
+        writeRecords(records);
+        event_buffers.erase(std::remove(event_buffers.begin(), event_buffers.end(), this), event_buffers.end());
+    }
+};
+
+}
+
+bool EventLog::open(const std::string& path) {
+    close();
+    std::lock_guard<std::mutex> lock(event_file_mutex);
+    event_file_stream.open(path, std::ios::binary | std::ios::trunc);
+    if (!event_file_stream.is_open()) {
+        Logger::error("Failed to open event log: ", path);
+        return false;
+    }
+    EventLogHeader header{};
+    std::copy(std::begin(EVENT_LOG_MAGIC), std::end(EVENT_LOG_MAGIC), header.magic);
+    header.version = EVENT_LOG_VERSION;
+    header.record_size = sizeof(EventRecord);
+    event_file_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    enabled_.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+void EventLog::close() {
+    enabled_.store(false, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(event_file_mutex);
+    for (EventBuffer* buffer : event_buffers) {
+        writeRecords(buffer->records);
+    }
+    if (event_file_stream.is_open()) {
+        event_file_stream.close();
+    }
+}
+
+void EventLog::append(EventType type, EntityType species, int r, int c, int target_r, int target_c, int energy) {
+    thread_local EventBuffer buffer;
+    buffer.records.push_back({tick_, static_cast<std::uint8_t>(type),
+                              static_cast<std::uint8_t>(species), 0, r, c, target_r, target_c, energy});
+    if (buffer.records.size() >= EVENT_BUFFER_RECORDS) {
+        std::lock_guard<std::mutex> lock(event_file_mutex);
+        writeRecords(buffer.records);
+    }
+}
@@ -1,6 +1,505 @@
-#include "utils/logger.hpp" 
+#include "utils/logger.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <ctime>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <vector>
+
+std::mutex log_output_mutex;
 
 #ifdef LOG_TO_FILE
 std::ofstream log_file_stream;
+std::atomic<bool> log_file_enabled{false};
+#endif
+
+namespace {
+
+struct LogRecord {
+    LogLevel level = LogLevel::INFO;
+    std::chrono::steady_clock::time_point time;
+    std::string message;
+};
+
+// Records are stamped with the monotonic clock and mapped to wall time
+// through one anchor pair taken at init, so timestamps never step backwards
+// and sub-second digits are consistent between lines.
+struct ClockAnchor {
+    std::chrono::system_clock::time_point wall = std::chrono::system_clock::now();
+    std::chrono::steady_clock::time_point steady = std::chrono::steady_clock::now();
+};
+ClockAnchor clock_anchor;
+LogTimestampPrecision timestamp_precision = LogTimestampPrecision::SECONDS;
+
+// "YYYY-mm-dd HH:MM:SS" for the last second seen by this thread; the
+// calendar conversion only runs when the second changes.
+struct TimestampCache {
+    long long second = -1;
+    char text[32];
+    std::size_t length = 0;
+};
+
+void appendTimestamp(std::string& out, std::chrono::steady_clock::time_point time) {
+    using namespace std::chrono;
+    const system_clock::time_point wall = clock_anchor.wall + duration_cast<system_clock::duration>(time - clock_anchor.steady);
+    const long long micros = duration_cast<microseconds>(wall.time_since_epoch()).count();
+    long long second = micros / 1000000;
+    long long fraction = micros % 1000000;
+    if (fraction < 0) {
+        --second;
+        fraction += 1000000;
+    }
+
+    thread_local TimestampCache cache;
+    if (second != cache.second) {
+        const std::time_t in_time_t = static_cast<std::time_t>(second);
+        std::tm timeinfo_tm;
+        #ifdef _MSC_VER
+        localtime_s(&timeinfo_tm, &in_time_t);
+        #else
+        localtime_r(&in_time_t, &timeinfo_tm);
+        #endif
+        cache.length = std::strftime(cache.text, sizeof(cache.text), "%Y-%m-%d %H:%M:%S", &timeinfo_tm);
+        cache.second = second;
+    }
+    out.append(cache.text, cache.length);
+
+    if (timestamp_precision == LogTimestampPrecision::SECONDS) {
+        return;
+    }
+    const bool millis = timestamp_precision == LogTimestampPrecision::MILLISECONDS;
+    int digits = millis ? 3 : 6;
+    long long value = millis ? fraction / 1000 : fraction;
+    char buffer[8];
+    buffer[0] = '.';
+    for (int i = digits; i > 0; --i) {
+        buffer[i] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    }
+    out.append(buffer, static_cast<std::size_t>(digits) + 1);
+}
+
+void appendLine(std::string& out, const LogRecord& record) {
+    appendTimestamp(out, record.time);
+    out += ' ';
+    out += logLevelToString(record.level);
+    out += ' ';
+    out += record.message;
+    out += '\n';
+}
+
+// A thread's buffered records, or (boundary) a marker that everything logged
+// so far belongs to the finished tick.
+struct LogBatch {
+    std::vector<LogRecord> records;
+    bool boundary = false;
+};
+
+// Bounded multi-producer, single-consumer ring (Vyukov's sequence-numbered
+// slots). Producers claim a slot with one CAS; the writer thread is the only
+// consumer, so popping needs no atomics beyond the slot sequence.
+class LogQueue {
+public:
+    explicit LogQueue(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        slots_ = std::make_unique<Slot[]>(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool tryPush(LogBatch& record) {
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & mask_];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.record = std::move(record);
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPop(LogBatch& record) {
+        Slot& slot = slots_[dequeue_pos_ & mask_];
+        const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence != dequeue_pos_ + 1) {
+            return false;
+        }
+        record = std::move(slot.record);
+        slot.sequence.store(dequeue_pos_ + mask_ + 1, std::memory_order_release);
+        ++dequeue_pos_;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence{0};
+        LogBatch record;
+    };
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_ = 0;
+    alignas(64) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(64) std::size_t dequeue_pos_ = 0;
+};
+
+// Moves lines that have waited longer than ThreadLogBuffer::MAX_AGE out of
+// the buffers of threads that have stopped logging. Defined below.
+void sweepStaleThreadBuffers(std::vector<LogRecord>& out);
+
+// Owns the queue and the thread that drains it into log_file_stream.
+// Producers hand over whole per-thread batches, so the queue sees one push
+// per batch rather than per line. The writer collects batches until a tick
+// boundary (or SEGMENT_TIMEOUT without one), orders that segment by
+// timestamp, and issues one write and flush for it. It sleeps briefly when
+// the queue is empty, so producers never touch a mutex. Every IDLE_WAIT and
+// before closing a tick it also takes stale lines from idle threads, which
+// would otherwise sit in their buffers until they log again or exit.
+class AsyncLogWriter {
+public:
+    AsyncLogWriter(std::size_t capacity, LogOverflowPolicy overflow)
+        : queue_(capacity), overflow_(overflow), thread_([this] { run(); }) {}
+
+    ~AsyncLogWriter() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_one();
+        thread_.join();
+    }
+
+    // Tick boundaries are never dropped, whatever the overflow policy: they
+    // carry no records and arrive once per tick, so waiting for a slot is
+    // short, and losing one would merge ticks in the output.
+    void push(LogBatch& batch) {
+        while (!queue_.tryPush(batch)) {
+            if (overflow_ != LogOverflowPolicy::BLOCK && !batch.boundary) {
+                dropped_.fetch_add(batch.records.size(), std::memory_order_relaxed);
+                batch.records.clear();
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    std::uint64_t getDroppedCount() const {
+        return dropped_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr auto IDLE_WAIT = std::chrono::milliseconds(5);
+    static constexpr auto SEGMENT_TIMEOUT = std::chrono::milliseconds(50);
+
+    void run() {
+        std::string output;
+        std::vector<LogRecord> pending;
+        std::chrono::steady_clock::time_point pending_since;
+        std::chrono::steady_clock::time_point last_sweep = std::chrono::steady_clock::now();
+        LogBatch batch;
+        const auto sweep = [&] {
+            const bool was_empty = pending.empty();
+            sweepStaleThreadBuffers(pending);
+            last_sweep = std::chrono::steady_clock::now();
+            if (was_empty && !pending.empty()) {
+                pending_since = last_sweep;
+            }
+        };
+        for (;;) {
+            bool popped = false;
+            while (queue_.tryPop(batch)) {
+                popped = true;
+                if (batch.boundary) {
+                    sweep();
+                    appendSegment(output, pending);
+                    continue;
+                }
+                if (pending.empty()) {
+                    pending_since = std::chrono::steady_clock::now();
+                }
+                std::move(batch.records.begin(), batch.records.end(), std::back_inserter(pending));
+            }
+            if (std::chrono::steady_clock::now() - last_sweep >= IDLE_WAIT) {
+                sweep();
+            }
+            bool stopping;
+            {
+                std::lock_guard<std::mutex> lock(wake_mutex_);
+                stopping = stopping_;
+            }
+            if (!pending.empty() && (stopping || std::chrono::steady_clock::now() - pending_since >= SEGMENT_TIMEOUT)) {
+                appendSegment(output, pending);
+            }
+            reportDropped(output);
+            if (!output.empty()) {
+                log_file_stream.write(output.data(), static_cast<std::streamsize>(output.size()));
+                log_file_stream.flush();
+                output.clear();
+            }
+            if (popped) {
+                continue;
+            }
+            if (stopping) {
+                return;
+            }
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            if (!stopping_) {
+                wake_.wait_for(lock, IDLE_WAIT);
+            }
+        }
+    }
+
+    static void appendSegment(std::string& output, std::vector<LogRecord>& segment) {
+        std::stable_sort(segment.begin(), segment.end(), [](const LogRecord& a, const LogRecord& b) {
+            return a.time < b.time;
+        });
+        for (const LogRecord& record : segment) {
+            appendLine(output, record);
+        }
+        segment.clear();
+    }
+
+    void reportDropped(std::string& output) {
+        if (overflow_ != LogOverflowPolicy::DROP_AND_REPORT) {
+            return;
+        }
+        const std::uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+        if (dropped == reported_) {
+            return;
+        }
+        LogRecord summary;
+        summary.level = LogLevel::WARNING;
+        summary.time = std::chrono::steady_clock::now();
+        summary.message = "Log queue full: dropped " + std::to_string(dropped - reported_) + " messages.";
+        appendLine(output, summary);
+        reported_ = dropped;
+    }
+
+    LogQueue queue_;
+    const LogOverflowPolicy overflow_;
+    std::atomic<std::uint64_t> dropped_{0};
+    std::uint64_t reported_ = 0;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+
+std::unique_ptr<AsyncLogWriter> async_writer;
+
+// Lines of this thread not yet handed to the writer. Handed over when full,
+// when the oldest line is older than MAX_AGE, on a warning or
+// error, at the end of each tick and when the thread exits. A thread that
+// stops logging cannot check MAX_AGE itself, so every buffer is registered
+// and the writer takes its stale lines (sweepStaleThreadBuffers). The two
+// sides hand the batch over with the `busy` flag: the owner sets it around
+// every access and only spins while the writer is mid-take; the writer
+// only tries it and skips a buffer its owner is using.
+struct ThreadLogBuffer {
+    static constexpr std::size_t MAX_RECORDS = 256;
+    static constexpr auto MAX_AGE = std::chrono::milliseconds(20);
+
+    LogBatch batch;
+    std::atomic<bool> busy{false};
+
+    ThreadLogBuffer();
+    ~ThreadLogBuffer();
+
+    void lock() {
+        while (busy.exchange(true, std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    void unlock() {
+        busy.store(false, std::memory_order_release);
+    }
+
+    void add(LogRecord record) {
+        const bool urgent = record.level >= LogLevel::WARNING;
+        lock();
+        batch.records.push_back(std::move(record));
+        if (urgent || batch.records.size() >= MAX_RECORDS ||
+            batch.records.back().time - batch.records.front().time >= MAX_AGE) {
+            flushLocked();
+        }
+        unlock();
+    }
+
+    void flush() {
+        lock();
+        flushLocked();
+        unlock();
+    }
+
+    void flushLocked() {
+        if (batch.records.empty()) {
+            return;
+        }
+        if (async_writer && log_file_enabled.load(std::memory_order_relaxed)) {
+            async_writer->push(batch);
+        }
+        batch.records.clear();
+    }
+};
+
+std::mutex thread_log_buffers_mutex;
+std::vector<ThreadLogBuffer*> thread_log_buffers;
+
+ThreadLogBuffer::ThreadLogBuffer() {
+    std::lock_guard<std::mutex> lock(thread_log_buffers_mutex);
+    thread_log_buffers.push_back(this);
+}
+
+// Unregisters before the final flush, so a sweep in progress finishes with
+// this buffer first and no later one can reach it.
+ThreadLogBuffer::~ThreadLogBuffer() {
+    {
+        std::lock_guard<std::mutex> lock(thread_log_buffers_mutex);
+        thread_log_buffers.erase(std::find(thread_log_buffers.begin(), thread_log_buffers.end(), this));
+    }
+    flush();
+}
+
+void sweepStaleThreadBuffers(std::vector<LogRecord>& out) {
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(thread_log_buffers_mutex);
+    for (ThreadLogBuffer* buffer : thread_log_buffers) {
+        if (buffer->busy.exchange(true, std::memory_order_acquire)) {
+            continue;
+        }
+        std::vector<LogRecord>& records = buffer->batch.records;
+        if (!records.empty() && now - records.front().time >= ThreadLogBuffer::MAX_AGE) {
+            std::move(records.begin(), records.end(), std::back_inserter(out));
+            records.clear();
+        }
+        buffer->unlock();
+    }
+}
+
+ThreadLogBuffer& threadLogBuffer() {
+    thread_local ThreadLogBuffer buffer;
+    return buffer;
+}
+
+// Sites that have suppressed at least one message, so that shutdown can
+// report counts for sites that went quiet mid-interval.
+std::mutex log_sites_mutex;
+std::vector<LogSite*> log_sites;
+
+}
+
+void Logger::init(const LogOptions& options) {
+    clock_anchor = ClockAnchor();
+    timestamp_precision = options.timestamp_precision;
+#ifdef LOG_TO_FILE
+    log_file_stream.open(LOG_TO_FILE, std::ios::app);
+    if (!log_file_stream.is_open()) {
+        std::cerr << "Failed to open log file: " << LOG_TO_FILE << std::endl;
+    } else {
+        if (options.async) {
+            async_writer = std::make_unique<AsyncLogWriter>(options.queue_capacity, options.overflow);
+        }
+        log_file_enabled.store(true, std::memory_order_relaxed);
+        log(LogLevel::INFO, "Logger initialized. Logging to file: " LOG_TO_FILE);
+    }
+#endif
+    log(LogLevel::INFO, "Logger initialized for console output.");
+}
+
+// Must not race with other threads still logging.
+void Logger::shutdown() {
+#ifdef LOG_TO_FILE
+    flushSuppressed();
+    if (log_file_stream.is_open()) {
+        log(LogLevel::INFO, "Logger shutting down.");
+        flushThreadBuffer();
+        log_file_enabled.store(false, std::memory_order_relaxed);
+        async_writer.reset();
+        log_file_stream.close();
+    }
 #endif
+}
+
+void Logger::flushThreadBuffer() {
+    if (async_writer) {
+        threadLogBuffer().flush();
+    }
+}
+
+void Logger::endTick() {
+    if (!async_writer || !log_file_enabled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    threadLogBuffer().flush();
+    LogBatch boundary;
+    boundary.boundary = true;
+    async_writer->push(boundary);
+}
+
+void Logger::flushSuppressed() {
+    std::vector<LogSite*> sites;
+    {
+        std::lock_guard<std::mutex> lock(log_sites_mutex);
+        sites = log_sites;
+    }
+    for (LogSite* site : sites) {
+        site->reportSuppressed();
+    }
+}
 
+void LogSite::registerSite() {
+    std::lock_guard<std::mutex> lock(log_sites_mutex);
+    log_sites.push_back(this);
+}
+
+void LogSite::reportSuppressed(std::uint64_t exclude) {
+    const std::uint64_t counted = suppressed_.exchange(0, std::memory_order_relaxed);
+    const std::uint64_t suppressed = counted > exclude ? counted - exclude : 0;
+    if (suppressed > 0) {
+        Logger::log(level_, "Suppressed ", suppressed, " similar messages from ", file_, ":", line_);
+    }
+}
+
+std::uint64_t Logger::getDroppedCount() {
+    return async_writer ? async_writer->getDroppedCount() : 0;
+}
+
+void Logger::write(LogLevel level, std::string message) {
+    LogRecord record{level, std::chrono::steady_clock::now(), std::move(message)};
+
+    if (level >= MIN_LOG_LEVEL_CONSOLE) {
+        std::string line;
+        appendLine(line, record);
+        std::lock_guard<std::mutex> lock(log_output_mutex);
+        std::cout << line << std::flush;
+    }
+
+#ifdef LOG_TO_FILE
+    if (level >= MIN_LOG_LEVEL_FILE && log_file_enabled.load(std::memory_order_relaxed)) {
+        if (async_writer) {
+            threadLogBuffer().add(std::move(record));
+        } else {
+            std::string line;
+            appendLine(line, record);
+            std::lock_guard<std::mutex> lock(log_output_mutex);
+            log_file_stream << line;
+        }
+    }
+#endif
+}
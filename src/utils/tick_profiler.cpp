@@ -0,0 +1,132 @@
+#include "utils/tick_profiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ostream>
+
+namespace {
+
+struct Summary {
+    double mean_us = 0.0;
+    double p50_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+    std::uint64_t buckets[TickProfiler::HISTOGRAM_BUCKETS] = {};
+};
+
+Summary summarize(std::vector<std::uint64_t> nanos) {
+    Summary summary;
+    if (nanos.empty()) {
+        return summary;
+    }
+    double total = 0.0;
+    for (std::uint64_t value : nanos) {
+        total += static_cast<double>(value);
+        summary.buckets[TickProfiler::bucketOf(value)]++;
+    }
+    std::sort(nanos.begin(), nanos.end());
+    auto rank = [&](double p) {
+        const size_t index = static_cast<size_t>(p / 100.0 * static_cast<double>(nanos.size() - 1) + 0.5);
+        return static_cast<double>(nanos[index]) / 1e3;
+    };
+    summary.mean_us = total / static_cast<double>(nanos.size()) / 1e3;
+    summary.p50_us = rank(50.0);
+    summary.p99_us = rank(99.0);
+    summary.max_us = static_cast<double>(nanos.back()) / 1e3;
+    return summary;
+}
+
+void writeRow(std::ostream& out, const char* name, const Summary& summary) {
+    char line[128];
+    std::snprintf(line, sizeof(line), "%-14s %12.1f %12.1f %12.1f %12.1f  ", name,
+                  summary.mean_us, summary.p50_us, summary.p99_us, summary.max_us);
+    out << line;
+    for (int b = 0; b < TickProfiler::HISTOGRAM_BUCKETS; ++b) {
+        if (summary.buckets[b] == 0) {
+            continue;
+        }
+        if (b == 0) {
+            out << " <1:";
+        } else {
+            out << " " << (1ull << (b - 1)) << ":";
+        }
+        out << summary.buckets[b];
+    }
+    out << "\n";
+}
+
+}
+
+TickProfiler::TickProfiler(size_t window) : ring_(std::max<size_t>(window, 1)) {}
+
+void TickProfiler::setWindow(size_t ticks) {
+    ring_.setCapacity(std::max<size_t>(ticks, 1));
+}
+
+void TickProfiler::record(const TickProfile& profile) {
+    ring_.push(profile);
+}
+
+void TickProfiler::clear() {
+    ring_.clear();
+}
+
+TickProfile TickProfiler::last() const {
+    return ring_.empty() ? TickProfile{} : ring_.back();
+}
+
+std::vector<TickProfile> TickProfiler::history() const {
+    return ring_.toVector();
+}
+
+int TickProfiler::bucketOf(std::uint64_t nanos) {
+    std::uint64_t micros = nanos / 1000;
+    int bucket = 0;
+    while (micros > 0 && bucket < HISTOGRAM_BUCKETS - 1) {
+        micros >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void TickProfiler::dump(std::ostream& out) const {
+    const std::vector<TickProfile> profiles = history();
+    if (profiles.empty()) {
+        out << "tick profile: no ticks recorded\n";
+        return;
+    }
+    out << "tick profile: " << profiles.size() << " ticks (" << profiles.front().tick << ".." << profiles.back().tick
+        << "), times in us, buckets as lower_bound_us:count\n";
+    char header[128];
+    std::snprintf(header, sizeof(header), "%-14s %12s %12s %12s %12s   %s\n", "", "mean", "p50", "p99", "max", "histogram");
+    out << header;
+
+    std::vector<std::uint64_t> nanos(profiles.size());
+    for (int p = 0; p < TICK_PHASE_COUNT; ++p) {
+        for (size_t i = 0; i < profiles.size(); ++i) {
+            nanos[i] = profiles[i].phase_ns[p];
+        }
+        writeRow(out, tickPhaseToString(static_cast<TickPhase>(p)), summarize(nanos));
+    }
+    static const char* const SPECIES_NAMES[PROFILED_SPECIES_COUNT] = {"algae", "herbivores", "predators"};
+    for (int s = 0; s < PROFILED_SPECIES_COUNT; ++s) {
+        for (size_t i = 0; i < profiles.size(); ++i) {
+            nanos[i] = profiles[i].species_ns[s];
+        }
+        writeRow(out, SPECIES_NAMES[s], summarize(nanos));
+    }
+
+    double updates = 0.0, moves = 0.0, eats = 0.0, births = 0.0, deaths = 0.0;
+    for (const TickProfile& profile : profiles) {
+        updates += static_cast<double>(profile.updates);
+        moves += static_cast<double>(profile.moves);
+        eats += static_cast<double>(profile.eats);
+        births += static_cast<double>(profile.births);
+        deaths += static_cast<double>(profile.deaths);
+    }
+    const double ticks = static_cast<double>(profiles.size());
+    char counts[192];
+    std::snprintf(counts, sizeof(counts), "per tick: %.1f updates, %.1f moves, %.1f eats, %.1f births, %.1f deaths\n",
+                  updates / ticks, moves / ticks, eats / ticks, births / ticks, deaths / ticks);
+    out << counts;
+}
@@ -0,0 +1,73 @@
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "utils/event_log.hpp"
+
+namespace {
+
+const char* speciesName(std::uint8_t species) {
+    switch (static_cast<EntityType>(species)) {
+        case EntityType::ALGAE:     return "algae";
+        case EntityType::HERBIVORE: return "herbivore";
+        case EntityType::PREDATOR:  return "predator";
+        default:                    return "unknown";
+    }
+}
+
+}
+
+// Turns a binary event stream written by EventLog into text or CSV on stdout.
+// Usage: OceanEventDecode <file> [--csv]
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <file> [--csv]\n";
+        return 2;
+    }
+    const bool csv = argc > 2 && std::strcmp(argv[2], "--csv") == 0;
+
+    std::ifstream in(argv[1], std::ios::binary);
+    if (!in) {
+        std::cerr << "Cannot open " << argv[1] << "\n";
+        return 1;
+    }
+    EventLogHeader header{};
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, EVENT_LOG_MAGIC, sizeof(EVENT_LOG_MAGIC)) != 0) {
+        std::cerr << argv[1] << " is not an event log\n";
+        return 1;
+    }
+    if (header.version != EVENT_LOG_VERSION || header.record_size != sizeof(EventRecord)) {
+        std::cerr << "Unsupported event log version " << header.version << " (record size " << header.record_size << ")\n";
+        return 1;
+    }
+
+    if (csv) {
+        std::printf("tick,event,species,r,c,target_r,target_c,energy\n");
+    }
+    std::vector<EventRecord> records(4096);
+    for (;;) {
+        in.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(EventRecord)));
+        const std::size_t count = static_cast<std::size_t>(in.gcount()) / sizeof(EventRecord);
+        for (std::size_t i = 0; i < count; ++i) {
+            const EventRecord& e = records[i];
+            const char* event = eventTypeToString(static_cast<EventType>(e.type));
+            if (csv) {
+                std::printf("%u,%s,%s,%d,%d,%d,%d,%d\n", e.tick, event, speciesName(e.species),
+                            e.r, e.c, e.target_r, e.target_c, e.energy);
+            } else if (e.target_r >= 0) {
+                std::printf("tick %u: %s %s (%d,%d) -> (%d,%d) E:%d\n", e.tick, speciesName(e.species), event,
+                            e.r, e.c, e.target_r, e.target_c, e.energy);
+            } else {
+                std::printf("tick %u: %s %s (%d,%d) E:%d\n", e.tick, speciesName(e.species), event, e.r, e.c, e.energy);
+            }
+        }
+        if (count < records.size()) {
+            break;
+        }
+    }
+    return 0;
+}